@@ -1,33 +1,199 @@
 #include "PCTester.h"
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
 #include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
-// Thread-safe console output implementation
-class SafeOutputImpl {
+// Asynchronous console output. Producers copy each line into a bounded
+// multi-producer ring with one CAS and never block on I/O; a background
+// writer drains the ring in order and hands whole batches to stdout, so
+// benchmark threads see neither a shared lock nor a flush per line.
+// Errors bypass the ring: they are rare, and one queued just before a
+// crash would never be written.
+class AsyncLog {
 public:
-    void print(const std::string& msg) {
-        std::lock_guard<std::mutex> lock(mtx_);
-        std::cout << msg << std::endl;
+    AsyncLog() : slots_(new Slot[kSlots]), tail_(0), written_(0), stopping_(false), writer_idle_(false) {
+        for (uint64_t i = 0; i < kSlots; i++) slots_[i].sequence.store(i, std::memory_order_relaxed);
+        writer_ = std::thread(&AsyncLog::writer_loop, this);
     }
     
-    void error(const std::string& msg) {
-        std::lock_guard<std::mutex> lock(mtx_);
-        std::cerr << "ERROR: " << msg << std::endl;
+    // Drains everything still queued before the process exits
+    ~AsyncLog() {
+        stopping_.store(true);
+        wake_writer();
+        writer_.join();
+        delete[] slots_;
+    }
+    
+    // A line longer than the whole ring is truncated. When the ring is
+    // full the producer yields until the writer has made room.
+    void enqueue(const char* data, size_t length) {
+        uint64_t chunks = length ? (length + kPayload - 1) / kPayload : 1;
+        if (chunks > kSlots) {
+            chunks = kSlots;
+            length = kSlots * kPayload;
+        }
+        
+        // Slots are freed strictly in order, so once the last slot of the
+        // run is free for this lap, every slot before it is free as well
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            uint64_t last = pos + chunks - 1;
+            int64_t lag = static_cast<int64_t>(slots_[last & kMask].sequence.load(std::memory_order_acquire) - last);
+            if (lag == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + chunks, std::memory_order_relaxed)) break;
+            } else if (lag < 0) {
+                wake_writer();
+                std::this_thread::yield();
+                pos = tail_.load(std::memory_order_relaxed);
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        
+        for (uint64_t i = 0; i < chunks; i++) {
+            Slot& slot = slots_[(pos + i) & kMask];
+            size_t offset = i * kPayload;
+            slot.length = static_cast<uint16_t>(std::min<size_t>(kPayload, length - std::min(length, offset)));
+            slot.last = i == chunks - 1;
+            if (slot.length) memcpy(slot.data, data + offset, slot.length);
+            slot.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        // Pairs with the fence in writer_loop: either the writer sees the
+        // slots before it sleeps or this sees it idle and wakes it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (writer_idle_.load(std::memory_order_relaxed)) wake_writer();
+    }
+    
+    // Writes an error line to stderr before returning, after every line
+    // queued ahead of it
+    void write_error(const char* data, size_t length) {
+        flush();
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        fwrite("ERROR: ", 1, 7, stderr);
+        fwrite(data, 1, length, stderr);
+        fputc('\n', stderr);
+        fflush(stderr);
+    }
+    
+    // Returns once every line queued before the call has reached stdio
+    void flush() {
+        uint64_t target = tail_.load(std::memory_order_acquire);
+        while (written_.load(std::memory_order_acquire) < target) {
+            wake_writer();
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
     }
     
 private:
-    std::mutex mtx_;
+    static constexpr uint64_t kSlots = 4096;
+    static constexpr uint64_t kMask = kSlots - 1;
+    static constexpr size_t kPayload = 112;
+    
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        uint16_t length;
+        bool last;
+        char data[kPayload];
+    };
+    
+    void wake_writer() {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+    
+    bool published(uint64_t head) const {
+        return slots_[head & kMask].sequence.load(std::memory_order_acquire) == head + 1;
+    }
+    
+    // Consumes every published slot and writes them as one batch
+    bool drain(uint64_t& head, std::string& batch) {
+        uint64_t start = head;
+        while (published(head)) {
+            Slot& slot = slots_[head & kMask];
+            batch.append(slot.data, slot.length);
+            if (slot.last) batch += '\n';
+            slot.sequence.store(head + kSlots, std::memory_order_release);
+            head++;
+        }
+        if (!batch.empty()) {
+            fwrite(batch.data(), 1, batch.size(), stdout);
+            fflush(stdout);
+            batch.clear();
+        }
+        written_.store(head, std::memory_order_release);
+        return head != start;
+    }
+    
+    void writer_loop() {
+        uint64_t head = 0;
+        std::string batch;
+        batch.reserve(kSlots * kPayload);
+        while (true) {
+            if (drain(head, batch)) continue;
+            if (stopping_.load()) break;
+            
+            // Producers only notify when the writer says it is idle, so
+            // the flag is raised before the last look at the ring; a
+            // producer that missed it published in time to be seen here
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            writer_idle_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            wake_cv_.wait(lock, [&]() { return stopping_.load() || published(head); });
+            writer_idle_.store(false, std::memory_order_relaxed);
+        }
+        drain(head, batch);
+    }
+    
+    Slot* slots_;
+    alignas(64) std::atomic<uint64_t> tail_;
+    alignas(64) std::atomic<uint64_t> written_;
+    std::atomic<bool> stopping_;
+    std::atomic<bool> writer_idle_;
+    std::mutex wake_mutex_;
+    std::mutex error_mutex_;
+    std::condition_variable wake_cv_;
+    std::thread writer_;
 };
 
+static AsyncLog& async_log() {
+    static AsyncLog log;
+    return log;
+}
+
+static std::atomic<bool> quiet_output(false);
+
 void SafeOutput::print(const std::string& msg) {
-    static SafeOutputImpl instance;
-    instance.print(msg);
+    if (quiet_output.load(std::memory_order_relaxed)) return;
+    async_log().enqueue(msg.data(), msg.size());
 }
 
 void SafeOutput::error(const std::string& msg) {
-    static SafeOutputImpl instance;
-    instance.error(msg);
+    async_log().write_error(msg.data(), msg.size());
+}
+
+void SafeOutput::print(const char* msg, size_t length) {
+    if (quiet_output.load(std::memory_order_relaxed)) return;
+    async_log().enqueue(msg, length);
+}
+
+void SafeOutput::error(const char* msg, size_t length) {
+    async_log().write_error(msg, length);
+}
+
+void SafeOutput::flush() {
+    async_log().flush();
+}
+
+void SafeOutput::set_quiet(bool quiet) {
+    quiet_output.store(quiet, std::memory_order_relaxed);
 }
 
 // Platform-specific implementation
@@ -41,9 +207,45 @@ void SafeOutput::error(const std::string& msg) {
     #error "Unsupported platform"
 #endif
 
-PCTester::PCTester() : pimpl(std::make_unique<Impl>()) {}
+PCTester::PCTester(const TestConfig& config) : pimpl(std::make_unique<Impl>(config)) {}
 PCTester::~PCTester() = default;
-void PCTester::run_full_diagnostics() { pimpl->run_full_diagnostics(); }
+void PCTester::run_full_diagnostics() { pimpl->run_stages(Impl::stage_names()); }
+
+void PCTester::run_stages(const std::vector<std::string>& stages) {
+    // Map each requested name onto the platform's spelling, then run them
+    // in the platform's order whatever order they were given in
+    auto lower = [](std::string name) {
+        for (char& c : name) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return name;
+    };
+    std::vector<std::string> known = Impl::stage_names();
+    std::vector<std::string> selected;
+    for (const std::string& stage : stages) {
+        auto it = std::find_if(known.begin(), known.end(),
+                               [&](const std::string& name) { return lower(name) == lower(stage); });
+        if (it == known.end()) {
+            std::string list;
+            for (const std::string& name : known) list += (list.empty() ? "" : ", ") + name;
+            throw std::invalid_argument("Unknown stage '" + stage + "' (available: " + list + ")");
+        }
+    }
+    for (const std::string& name : known) {
+        auto it = std::find_if(stages.begin(), stages.end(),
+                               [&](const std::string& stage) { return lower(name) == lower(stage); });
+        if (it != stages.end()) selected.push_back(name);
+    }
+    pimpl->run_stages(selected);
+}
+
+std::vector<std::string> PCTester::stage_names() { return Impl::stage_names(); }
 void PCTester::generate_html_report(const std::string& filename) const { 
     pimpl->generate_html_report(filename); 
 }   
+void PCTester::export_results(const std::string& filename, ResultFormat format) const {
+    pimpl->export_results(filename, format);
+}
+int PCTester::compare_to_baseline(const std::string& path) {
+    return pimpl->compare_to_baseline(path);
+}
+void PCTester::run_daemon() { pimpl->run_daemon(); }
+void PCTester::run_network_server(uint16_t port) { Impl::network_server(port); }
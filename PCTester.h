@@ -6,21 +6,240 @@
 #include <map>
 #include <cstdint>
 
+// Thread-safe console output. Printed lines are queued and written by a
+// background thread, so callers never wait on the terminal; errors are
+// written to stderr before error() returns.
 class SafeOutput {
 public:
     static void print(const std::string& msg);
     static void error(const std::string& msg);
+    
+    // Preformatted text in a caller-owned buffer; no allocation, for use
+    // on timed paths
+    static void print(const char* msg, size_t length);
+    static void error(const char* msg, size_t length);
+    
+    // Blocks until everything printed so far has been written
+    static void flush();
+    
+    // Drops print() output from now on; errors are still written
+    static void set_quiet(bool quiet);
+};
+
+// One cache level as reported by /sys/devices/system/cpu/cpu0/cache
+struct CacheInfo {
+    int level;
+    std::string type;       // Data, Instruction or Unified
+    uint64_t size;          // bytes
+    size_t line_size;
+    std::string shared_cpus;
+};
+
+// One NUMA node from /sys/devices/system/node
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+    uint64_t memory_size;   // bytes
+};
+
+// One PCI function from /sys/bus/pci/devices
+struct PciDevice {
+    std::string address;    // domain:bus:device.function, e.g. 0000:01:00.0
+    uint32_t class_code;    // 0x030000 is a VGA controller
+    uint16_t vendor_id;
+    uint16_t device_id;
+    std::string name;       // from pci.ids when installed, else empty
+    std::string driver;
+};
+
+// One memory module from SMBIOS (type 17) or EDAC
+struct DimmInfo {
+    std::string locator;    // slot, e.g. DIMM_A1
+    uint64_t size;          // bytes
+    std::string type;       // DDR4, DDR5, ...
+    int speed_mts;          // configured speed, 0 when unknown
+    std::string manufacturer;
+    std::string part_number;
 };
 
 struct SystemInfo {
     std::string os_name;
     std::string cpu_name;
-    size_t cpu_cores;
+    size_t cpu_sockets = 0;
+    size_t cpu_cores;       // physical cores over all sockets
     size_t cpu_threads;
     uint64_t memory_size;
     std::string gpu_name;
-    uint64_t gpu_memory;
+    uint64_t gpu_memory;    // MB, 0 when unknown
     std::vector<std::string> disk_names;
+    std::vector<CacheInfo> caches;
+    std::vector<NumaNode> numa_nodes;
+    std::vector<PciDevice> pci_devices;
+    std::vector<DimmInfo> dimms;
+};
+
+// Per-ISA vector kernel throughput (see PCTester_SIMD.h)
+struct SimdScore {
+    std::string isa;
+    double fma_gflops;
+    double dot_gflops;
+    double saxpy_gbs;
+    double hash_gops;
+};
+
+// One single-threaded CPU workload kernel. score is 1000 times the rate
+// over the reference core's; weight is its share of the composite.
+struct CpuWorkloadScore {
+    std::string name;
+    std::string unit;
+    std::string engine;     // hardware path taken, e.g. "AES-NI", or "portable"
+    double rate;
+    double score;
+    double weight;
+};
+
+// One STREAM pass at a given thread count, in GB/s
+struct StreamResult {
+    size_t threads;
+    double copy_gbs;
+    double scale_gbs;
+    double add_gbs;
+    double triad_gbs;
+};
+
+// One disk I/O profile (see PCTester_Linux_Disk.h)
+struct DiskProfileResult {
+    std::string name;
+    size_t block_size;
+    int queue_depth;
+    double mbps;
+    double iops;
+    double p50_us;
+    double p99_us;
+    double p999_us;
+};
+
+// Small append + flush latency for one durability mode
+struct SyncLatencyResult {
+    std::string mode;
+    size_t write_size;
+    uint64_t count;
+    double mean_us;
+    double p50_us;
+    double p90_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+    std::vector<std::pair<double, uint64_t>> buckets;  // log2 bucket upper bound (us), count
+};
+
+// One memory-mapped file scan
+struct MmapResult {
+    std::string pattern;    // sequential or random
+    std::string hint;       // none, MAP_POPULATE, MADV_*
+    bool write;
+    double mbps;            // pages visited over the whole scan, mmap() included
+    double seconds;
+    double map_seconds;     // the mmap() call alone, where MAP_POPULATE prefaults
+    double huge_page_kb;    // of the mapping backed by huge pages, NaN if unknown
+    uint64_t minor_faults;
+    uint64_t major_faults;
+};
+
+// One server event loop of the connection stress test
+struct EventLoopResult {
+    int cpu;
+    int connections;        // accepted through this loop's SO_REUSEPORT listener
+    double requests_per_sec;
+};
+
+// One tick of the telemetry sampler; fields a machine does not expose stay 0
+struct TelemetrySample {
+    double time_s;          // since the sampler was created
+    double cpu_temp_c;
+    double gpu_temp_c;
+    double thermal_headroom_c;  // least (limit - temperature) over the CPU sensors
+    double cpu_util_pct;
+    double freq_avg_mhz;
+    double freq_min_mhz;
+    double freq_max_mhz;
+    double package_power_w;
+};
+
+// Telemetry recorded while one test stage ran
+struct TelemetryPhase {
+    std::string name;
+    double start_s;
+    double end_s;
+    std::vector<TelemetrySample> samples;
+    std::vector<std::pair<int, double>> core_freq_mhz;  // logical CPU id, mean MHz
+};
+
+// Sustained slowdown found in the telemetry of one stage
+struct ThrottleEvent {
+    std::string phase;
+    std::string cause;      // frequency, thermal or score
+    double onset_s;         // since the stage (or measurement) started
+    double duration_s;
+    double perf_loss_pct;
+};
+
+// Hardware counters over one test stage: its threads, or everything on
+// its CPUs when per_cpu is set. Each count is -1 when the kernel or CPU
+// could not provide that event.
+struct PerfCounters {
+    bool available = false;
+    bool per_cpu = false;   // counted everything on the stage's CPUs, not just its threads
+    bool partial = false;   // the stage ran tasks on scheduler workers that were not counted
+    bool overlapped = false;    // per-CPU counting skipped: another lane shared the CPUs
+    double seconds = 0.0;
+    double cycles = -1.0;
+    double instructions = -1.0;
+    double ipc = -1.0;
+    double llc_misses = -1.0;
+    double branch_misses = -1.0;
+    double dtlb_misses = -1.0;
+};
+
+// Repeated measurement of one kernel after outlier rejection
+struct BenchmarkStats {
+    std::string name;
+    std::string unit;
+    int warmup_runs;
+    int runs;               // measured runs, outliers included
+    int outliers;
+    double median;
+    double mean;
+    double min;
+    double max;
+    double stddev;
+    double ci95_low;
+    double ci95_high;
+    double rse_pct;         // standard error of the mean, percent of the mean
+    bool converged;         // reached the target RSE before a cap
+    std::vector<double> samples;    // every measured run in order, outliers included
+};
+
+// One benchmark compared against the same measurement in a baseline run
+struct BaselineDelta {
+    std::string name;
+    std::string unit;
+    double baseline;        // medians
+    double current;
+    double delta_pct;       // difference of the means, percent of the baseline mean
+    double ci95_low_pct;
+    double ci95_high_pct;
+    std::string verdict;    // regression, improvement or unchanged
+};
+
+// One daemon micro-probe measurement
+struct ProbeSample {
+    double time_s;          // Unix time the round started
+    std::string probe;
+    int cpu;                // logical CPU the probe ran on, -1 if unpinned
+    double value;
+    std::string unit;
+    double host_util_pct;   // host CPU utilization before the round
 };
 
 struct TestResults {
@@ -33,15 +252,171 @@ struct TestResults {
     double network_latency;
     double network_bandwidth;
     double gpu_score;
+
+    // Multi-threaded CPU engine (one pinned worker per logical CPU)
+    double cpu_single_score;
+    double cpu_multi_score;
+    double cpu_scaling_efficiency;
+    std::vector<std::pair<int, double>> cpu_core_scores; // logical CPU id, score
+    std::vector<CpuWorkloadScore> cpu_workload_scores;
+    double cpu_core_composite;  // weighted geometric mean of the workload scores
+    std::vector<SimdScore> simd_scores;
+    std::vector<StreamResult> stream_results;
+    
+    // Pointer-chasing load latency (working set bytes, ns per load)
+    std::vector<std::pair<uint64_t, double>> latency_curve;
+    std::vector<uint64_t> detected_cache_sizes;
+    double ram_latency_ns;
+    
+    // Cross-node matrices indexed [cpu node][memory node], in SystemInfo::numa_nodes order
+    std::vector<std::vector<double>> numa_bandwidth_gbs;
+    std::vector<std::vector<double>> numa_latency_ns;
+    
+    // Software rasterizer standing in for the GPU; gpu_score is the
+    // triangle rate
+    std::string gpu_engine;
+    double gpu_triangle_rate;   // Mtriangles/s
+    double gpu_fill_rate;       // Gpixels/s of covered fragments
+    double gpu_compute_rate;    // Gpixels/s through the shading pass
+    
+    std::string disk_engine;
+    std::vector<DiskProfileResult> disk_profiles;
+    std::vector<SyncLatencyResult> disk_sync_results;
+    std::vector<MmapResult> mmap_results;
+    
+    // Network: network_bandwidth is aggregate TCP goodput in Mbit/s and
+    // network_latency the median request/response RTT in microseconds
+    std::string network_target;
+    int network_streams;
+    double network_rtt_p99_us;
+    double network_rtt_p999_us;
+    double network_udp_pps;
+    double network_udp_loss;            // percent
+    
+    // Many-connection epoll stress against per-core loopback servers
+    int network_stress_connections;
+    double network_stress_rps;
+    double network_stress_p50_us;
+    double network_stress_p99_us;
+    double network_stress_p999_us;
+    double network_stress_balance;      // slowest loop / busiest loop
+    std::vector<EventLoopResult> network_stress_loops;
+    
+    double telemetry_period_ms;
+    std::vector<TelemetryPhase> telemetry_phases;
+    
+    // Throttling: all-core score per time slice (seconds, score) and the
+    // limits the samples were checked against (0 when unknown)
+    std::vector<std::pair<double, double>> cpu_score_timeline;
+    double nominal_freq_mhz;
+    double thermal_limit_c;
+    std::vector<ThrottleEvent> throttle_events;
+    
+    // Per-stage hardware counters keyed by stage name
+    std::map<std::string, PerfCounters> perf_counters;
+    
+    // Every repeated measurement, in the order it ran; headline scores
+    // above are the medians of these
+    std::vector<BenchmarkStats> bench_stats;
+    
+    // Comparison with a stored run; empty source when none was loaded
+    std::string baseline_source;
+    std::string baseline_cpu;
+    std::vector<BaselineDelta> baseline_deltas;
+    int baseline_regressions;
+};
+
+// User-tunable knobs for the test run
+struct TestConfig {
+    // Disk test: a directory gets a temporary scratch file. An existing
+    // file or block device is only read unless disk_write_file is set.
+    std::string disk_path = ".";
+    bool disk_write_file = false;       // overwrite an existing file in place
+    uint64_t disk_file_size = 1ull << 30;
+    double disk_seconds = 2.0;          // per I/O profile
+    std::string disk_engine = "auto";   // auto, io_uring or threads
+    bool disk_sqpoll = false;           // io_uring kernel-side submission polling
+    
+    // Network test: an empty peer runs against an in-process server on
+    // 127.0.0.1, otherwise the host running pctester --network-server
+    std::string network_peer;
+    uint16_t network_port = 5201;
+    int network_streams = 4;
+    double network_seconds = 2.0;       // per measurement
+    int network_stress_connections = 10000; // loopback connection stress, 0 to skip
+    
+    // Telemetry sampling period, clamped to 10-100 ms
+    double telemetry_period_ms = 50.0;
+    
+    // Benchmark repetitions: each kernel is warmed up, then repeated until
+    // the relative standard error of its mean drops to the target
+    int bench_warmup_runs = 1;
+    int bench_min_runs = 5;
+    int bench_max_runs = 30;
+    double bench_target_rse_pct = 1.0;
+    double bench_max_seconds = 4.0;     // per kernel, warmup included
+    
+    // Worker threads for the CPU and STREAM stages, 0 for every online CPU
+    int threads = 0;
+    
+    // Bytes per STREAM array, 0 for 4x the last-level cache
+    uint64_t stream_array_bytes = 0;
+    
+    // Baseline comparison: a change only counts when its 95% interval
+    // excludes zero and it is at least this large
+    double regression_threshold_pct = 3.0;
+    
+    // Daemon mode: a round of micro-probes every interval at idle
+    // priority, skipped while host CPU utilization is above the limit
+    double daemon_interval_s = 60.0;
+    double daemon_max_util_pct = 50.0;
+    size_t daemon_window = 1440;        // probe samples kept in memory
+    std::string daemon_socket = "/tmp/pctester.sock";
+    
+    // OpenMetrics endpoint (http://127.0.0.1:<port>/metrics) with the
+    // results so far and live telemetry; 0 for none. Linux only.
+    uint16_t metrics_port = 0;
+    
+    // Run the storage stages beside the compute stages instead of after
+    // them. Finishes sooner, but each lane perturbs the other's numbers.
+    bool pipeline_stages = false;
+};
+
+// Machine-readable result formats (see PCTester_Export.h)
+enum class ResultFormat {
+    JsonLines,
+    Csv
 };
 
 class PCTester {
 public:
-    PCTester();
+    explicit PCTester(const TestConfig& config = TestConfig());
     ~PCTester();
     
     void run_full_diagnostics();
+    
+    // Runs only the named stages (case-insensitive, see stage_names()), in
+    // the same order and with the same telemetry as a full run. Throws
+    // std::invalid_argument for a name this platform does not have.
+    void run_stages(const std::vector<std::string>& stages);
+    
+    // Every stage of a full run on this platform, in run order
+    static std::vector<std::string> stage_names();
+    
     void generate_html_report(const std::string& filename) const;
+    void export_results(const std::string& filename, ResultFormat format) const;
+    
+    // Compares this run with a JSON Lines result file, or with the file for
+    // this CPU model when path is a directory. Returns the number of
+    // significant regressions; shown in the report generated afterwards.
+    int compare_to_baseline(const std::string& path);
+    
+    // Continuous low-priority probing (Linux); serves the rolling window
+    // as JSON Lines on config.daemon_socket and blocks until SIGINT/SIGTERM
+    void run_daemon();
+    
+    // Far end for network tests on another host; blocks until killed
+    static void run_network_server(uint16_t port);
 
 private:
     class Impl;
@@ -0,0 +1,335 @@
+#include "PCTester_Baseline.h"
+#include "PCTester_Export.h"
+#include "PCTester_Harness.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Fields of one flat JSON object as written by JsonLinesWriter. Numbers
+// keep their text, null becomes empty. Returns false on anything nested or
+// malformed, which simply skips the line.
+bool parse_flat_object(const std::string& line, std::map<std::string, std::string>& fields) {
+    size_t pos = 0;
+    auto skip_space = [&]() {
+        while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos]))) pos++;
+    };
+    auto parse_string = [&](std::string& out) {
+        if (pos >= line.size() || line[pos] != '"') return false;
+        pos++;
+        out.clear();
+        while (pos < line.size() && line[pos] != '"') {
+            char c = line[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= line.size()) return false;
+            char escaped = line[pos++];
+            switch (escaped) {
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    if (pos + 4 > line.size()) return false;
+                    unsigned code = static_cast<unsigned>(std::strtoul(line.substr(pos, 4).c_str(), nullptr, 16));
+                    pos += 4;
+                    // The writer only escapes control characters, so ASCII suffices
+                    out += code < 0x80 ? static_cast<char>(code) : '?';
+                    break;
+                }
+                default: out += escaped;
+            }
+        }
+        if (pos >= line.size()) return false;
+        pos++;
+        return true;
+    };
+    
+    fields.clear();
+    skip_space();
+    if (pos >= line.size() || line[pos++] != '{') return false;
+    skip_space();
+    if (pos < line.size() && line[pos] == '}') return true;
+    while (pos < line.size()) {
+        std::string key;
+        skip_space();
+        if (!parse_string(key)) return false;
+        skip_space();
+        if (pos >= line.size() || line[pos++] != ':') return false;
+        skip_space();
+        std::string value;
+        if (pos < line.size() && line[pos] == '"') {
+            if (!parse_string(value)) return false;
+        } else {
+            size_t end = line.find_first_of(",} \t\r", pos);
+            if (end == std::string::npos) return false;
+            value = line.substr(pos, end - pos);
+            if (value == "null") value.clear();
+            else if (value.empty() || value[0] == '{' || value[0] == '[') return false;
+            pos = end;
+        }
+        fields[key] = value;
+        skip_space();
+        if (pos >= line.size()) return false;
+        if (line[pos] == '}') return true;
+        if (line[pos++] != ',') return false;
+    }
+    return false;
+}
+
+double number_field(const std::map<std::string, std::string>& fields, const char* name) {
+    auto it = fields.find(name);
+    if (it == fields.end() || it->second.empty()) return std::nan("");
+    char* end = nullptr;
+    double value = std::strtod(it->second.c_str(), &end);
+    return end == it->second.c_str() ? std::nan("") : value;
+}
+
+std::string string_field(const std::map<std::string, std::string>& fields, const char* name) {
+    auto it = fields.find(name);
+    return it == fields.end() ? std::string() : it->second;
+}
+
+// Export fields compared as headline metrics, with the identity fields
+// that tell one record of a type from another
+struct HeadlineField {
+    const char* record;
+    std::vector<const char*> keys;
+    const char* field;
+    const char* unit;
+    bool lower_is_better;
+};
+
+const std::vector<HeadlineField>& headline_fields() {
+    static const std::vector<HeadlineField> fields = {
+        { "disk_profile", { "profile", "queue_depth" }, "mbps", "MB/s", false },
+        { "disk_profile", { "profile", "queue_depth" }, "p99_us", "us", true },
+        { "disk_sync", { "mode" }, "p50_us", "us", true },
+        { "disk_sync", { "mode" }, "p99_us", "us", true },
+        { "disk_sync", { "mode" }, "p999_us", "us", true },
+        { "mmap", { "pattern", "hint", "access" }, "mbps", "MB/s", false },
+        { "stream", { "threads" }, "triad_gbs", "GB/s", false },
+        { "latency", { "working_set_bytes" }, "ns", "ns", true },
+        { "numa", { "cpu_node", "mem_node" }, "bandwidth_gbs", "GB/s", false },
+        { "numa", { "cpu_node", "mem_node" }, "latency_ns", "ns", true },
+        { "summary", {}, "network_bandwidth_mbits", "Mbit/s", false },
+        { "summary", {}, "network_rtt_p50_us", "us", true },
+        { "summary", {}, "network_rtt_p99_us", "us", true },
+        { "summary", {}, "network_udp_pps", "packets/s", false },
+        { "summary", {}, "network_stress_rps", "requests/s", false },
+        { "summary", {}, "network_stress_p99_us", "us", true },
+    };
+    return fields;
+}
+
+void add_headline_metrics(const std::map<std::string, std::string>& fields, std::vector<BaselineMetric>& metrics) {
+    std::string type = string_field(fields, "type");
+    for (const auto& headline : headline_fields()) {
+        if (type != headline.record) continue;
+        double value = number_field(fields, headline.field);
+        if (!std::isfinite(value) || value == 0.0) continue;
+        std::string name = type;
+        for (const char* key : headline.keys) name += " " + std::string(key) + "=" + string_field(fields, key);
+        name += " " + std::string(headline.field);
+        metrics.push_back({ name, headline.unit, value, headline.lower_is_better });
+    }
+}
+
+bool lower_is_better(const std::string& unit) {
+    return unit == "ns" || unit == "us" || unit == "ms" || unit == "s";
+}
+
+int kept_samples(const BenchmarkStats& stats) {
+    return stats.runs - stats.outliers;
+}
+
+} // namespace
+
+std::string baseline_file_name(const std::string& cpu_name) {
+    std::string name;
+    for (unsigned char c : cpu_name) {
+        if (std::isalnum(c)) {
+            name += static_cast<char>(std::tolower(c));
+        } else if (!name.empty() && name.back() != '_') {
+            name += '_';
+        }
+    }
+    while (!name.empty() && name.back() == '_') name.pop_back();
+    return (name.empty() ? std::string("unknown_cpu") : name) + ".jsonl";
+}
+
+Baseline load_baseline(const std::string& path, const std::string& cpu_name) {
+    Baseline baseline;
+    baseline.source = path;
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error)) {
+        baseline.source = (std::filesystem::path(path) / baseline_file_name(cpu_name)).string();
+    }
+    
+    std::ifstream file(baseline.source);
+    if (!file) throw std::runtime_error("Cannot open baseline " + baseline.source);
+    
+    std::string line;
+    std::map<std::string, std::string> fields;
+    while (std::getline(file, line)) {
+        if (!parse_flat_object(line, fields)) continue;
+        std::string type = string_field(fields, "type");
+        add_headline_metrics(fields, baseline.metrics);
+        if (type == "system") {
+            baseline.cpu = string_field(fields, "cpu");
+        } else if (type == "benchmark") {
+            BaselineEntry entry;
+            entry.name = string_field(fields, "name");
+            entry.unit = string_field(fields, "unit");
+            entry.median = number_field(fields, "median");
+            entry.mean = number_field(fields, "mean");
+            entry.stddev = number_field(fields, "stddev");
+            double runs = number_field(fields, "runs");
+            double outliers = number_field(fields, "outliers");
+            entry.samples = std::isfinite(runs) ? static_cast<int>(runs - (std::isfinite(outliers) ? outliers : 0.0)) : 0;
+            if (entry.name.empty() || !std::isfinite(entry.mean)) continue;
+            if (!std::isfinite(entry.stddev)) entry.stddev = 0.0;
+            baseline.entries.push_back(entry);
+        }
+    }
+    if (baseline.entries.empty() && baseline.metrics.empty()) {
+        throw std::runtime_error("Baseline " + baseline.source + " has no benchmark or headline records");
+    }
+    return baseline;
+}
+
+std::vector<BaselineDelta> compare_with_baseline(const Baseline& baseline,
+                                                 const std::vector<BenchmarkStats>& current,
+                                                 double threshold_pct) {
+    std::vector<BaselineDelta> deltas;
+    for (const auto& stats : current) {
+        const BaselineEntry* reference = nullptr;
+        for (const auto& entry : baseline.entries) {
+            if (entry.name == stats.name && entry.unit == stats.unit) reference = &entry;
+        }
+        if (!reference || reference->mean == 0.0) continue;
+        
+        BaselineDelta delta;
+        delta.name = stats.name;
+        delta.unit = stats.unit;
+        delta.baseline = reference->median;
+        delta.current = stats.median;
+        double scale = 100.0 / std::fabs(reference->mean);
+        delta.delta_pct = (stats.mean - reference->mean) * scale;
+        
+        // Welch: unequal variances, Welch-Satterthwaite degrees of freedom
+        // rounded down so the t quantile errs wide
+        int n_base = reference->samples;
+        int n_cur = kept_samples(stats);
+        if (n_base < 2 || n_cur < 2) {
+            delta.ci95_low_pct = delta.ci95_high_pct = delta.delta_pct;
+            delta.verdict = "too few runs";
+            deltas.push_back(delta);
+            continue;
+        }
+        double var_base = reference->stddev * reference->stddev / n_base;
+        double var_cur = stats.stddev * stats.stddev / n_cur;
+        double standard_error = std::sqrt(var_base + var_cur);
+        double df = n_base + n_cur - 2;
+        if (var_base + var_cur > 0.0) {
+            df = (var_base + var_cur) * (var_base + var_cur) /
+                 (var_base * var_base / (n_base - 1) + var_cur * var_cur / (n_cur - 1));
+        }
+        double margin = student_t95(static_cast<size_t>(std::max(1.0, std::floor(df)))) * standard_error * scale;
+        delta.ci95_low_pct = delta.delta_pct - margin;
+        delta.ci95_high_pct = delta.delta_pct + margin;
+        
+        bool significant = (delta.ci95_low_pct > 0.0 || delta.ci95_high_pct < 0.0) &&
+                           std::fabs(delta.delta_pct) >= threshold_pct;
+        bool better = lower_is_better(stats.unit) ? delta.delta_pct < 0.0 : delta.delta_pct > 0.0;
+        delta.verdict = !significant ? "unchanged" : better ? "improvement" : "regression";
+        deltas.push_back(delta);
+    }
+    return deltas;
+}
+
+std::vector<BaselineMetric> headline_metrics(const SystemInfo& info, const TestResults& results) {
+    std::stringstream records;
+    JsonLinesWriter writer(records);
+    write_results(writer, info, results);
+    
+    std::vector<BaselineMetric> metrics;
+    std::string line;
+    std::map<std::string, std::string> fields;
+    while (std::getline(records, line)) {
+        if (parse_flat_object(line, fields)) add_headline_metrics(fields, metrics);
+    }
+    return metrics;
+}
+
+std::vector<BaselineDelta> compare_headline_metrics(const Baseline& baseline,
+                                                    const std::vector<BaselineMetric>& current,
+                                                    double threshold_pct) {
+    std::vector<BaselineDelta> deltas;
+    for (const auto& metric : current) {
+        const BaselineMetric* reference = nullptr;
+        for (const auto& entry : baseline.metrics) {
+            if (entry.name == metric.name && entry.unit == metric.unit) reference = &entry;
+        }
+        if (!reference) continue;
+        
+        BaselineDelta delta;
+        delta.name = metric.name;
+        delta.unit = metric.unit;
+        delta.baseline = reference->value;
+        delta.current = metric.value;
+        delta.delta_pct = (metric.value - reference->value) * 100.0 / std::fabs(reference->value);
+        delta.ci95_low_pct = delta.ci95_high_pct = std::nan("");
+        
+        bool better = metric.lower_is_better ? delta.delta_pct < 0.0 : delta.delta_pct > 0.0;
+        delta.verdict = std::fabs(delta.delta_pct) < threshold_pct ? "unchanged" : better ? "improvement" : "regression";
+        deltas.push_back(delta);
+    }
+    return deltas;
+}
+
+int apply_baseline(const std::string& path, double threshold_pct, const SystemInfo& info, TestResults& results) {
+    Baseline baseline = load_baseline(path, info.cpu_name);
+    SafeOutput::print("[BASELINE] Comparing with " + baseline.source);
+    if (!baseline.cpu.empty() && baseline.cpu != info.cpu_name) {
+        SafeOutput::print("[BASELINE] Warning: baseline was measured on " + baseline.cpu);
+    }
+    
+    results.baseline_source = baseline.source;
+    results.baseline_cpu = baseline.cpu;
+    results.baseline_deltas = compare_with_baseline(baseline, results.bench_stats, threshold_pct);
+    std::vector<BaselineDelta> headline = compare_headline_metrics(baseline, headline_metrics(info, results), threshold_pct);
+    results.baseline_deltas.insert(results.baseline_deltas.end(), headline.begin(), headline.end());
+    results.baseline_regressions = 0;
+    for (const auto& delta : results.baseline_deltas) {
+        if (delta.verdict == "regression") results.baseline_regressions++;
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << "[BASELINE] " << delta.name << ": " << delta.baseline << " -> "
+           << delta.current << " " << delta.unit << ", " << std::showpos << delta.delta_pct << "%";
+        if (std::isnan(delta.ci95_low_pct)) {
+            ss << " (single run, threshold only)";
+        } else {
+            ss << " (95% CI " << delta.ci95_low_pct << " to " << delta.ci95_high_pct << "%)";
+        }
+        ss << std::noshowpos << " " << delta.verdict;
+        SafeOutput::print(ss.str());
+    }
+    if (results.baseline_deltas.empty()) {
+        SafeOutput::print("[BASELINE] No measurements in common with the baseline");
+    }
+    std::stringstream ss;
+    ss << "[BASELINE] " << results.baseline_regressions << " significant regression(s) at a " << threshold_pct << "% threshold";
+    SafeOutput::print(ss.str());
+    return results.baseline_regressions;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "PCTester.h"
+#include <string>
+#include <vector>
+
+// Summary of one measurement as stored by the "benchmark" records of a
+// JSON Lines export (see PCTester_Export.h)
+struct BaselineEntry {
+    std::string name;
+    std::string unit;
+    double median;
+    double mean;
+    double stddev;
+    int samples;    // runs kept after outlier rejection
+};
+
+// A headline number measured once per run (a disk profile, a network
+// RTT percentile, a NUMA cell, ...), named after its export record
+struct BaselineMetric {
+    std::string name;       // e.g. "disk_profile profile=Random read queue_depth=4 mbps"
+    std::string unit;
+    double value;
+    bool lower_is_better;
+};
+
+struct Baseline {
+    std::string source;     // the file actually read
+    std::string cpu;
+    std::vector<BaselineEntry> entries;
+    std::vector<BaselineMetric> metrics;
+};
+
+// Reads a JSON Lines export. When path is a directory, reads the reference
+// file for this CPU model in it, named by baseline_file_name(cpu_name).
+// Throws std::runtime_error if nothing usable can be read.
+Baseline load_baseline(const std::string& path, const std::string& cpu_name);
+
+// "Intel(R) Core(TM) i7-9700K CPU @ 3.60GHz" -> "intel_r_core_tm_i7_9700k_cpu_3_60ghz.jsonl"
+std::string baseline_file_name(const std::string& cpu_name);
+
+// Welch's comparison of the means of every measurement present in both
+// runs. A delta is a regression or improvement only when its 95%
+// confidence interval excludes zero and it is at least threshold_pct.
+// Time units (ns, us, ms, s) are lower-is-better; everything else is a rate.
+std::vector<BaselineDelta> compare_with_baseline(const Baseline& baseline,
+                                                 const std::vector<BenchmarkStats>& current,
+                                                 double threshold_pct);
+
+// Headline metrics of a run, read back from its own JSON Lines export so
+// they are named exactly as load_baseline names those of a saved run.
+// Zero values are left out, since they mean the stage did not run.
+std::vector<BaselineMetric> headline_metrics(const SystemInfo& info, const TestResults& results);
+
+// Percent change of every headline metric present in both runs. With a
+// single value per run there is no confidence interval (the CI bounds are
+// NaN), so the verdict rests on threshold_pct alone.
+std::vector<BaselineDelta> compare_headline_metrics(const Baseline& baseline,
+                                                    const std::vector<BaselineMetric>& current,
+                                                    double threshold_pct);
+
+// Loads the baseline, prints one [BASELINE] line per delta, and stores the
+// comparison in results. Returns the number of regressions.
+int apply_baseline(const std::string& path, double threshold_pct, const SystemInfo& info, TestResults& results);
@@ -0,0 +1,524 @@
+#include "PCTester_Export.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+// Integers (byte counts, ids) print exactly; everything else keeps ten
+// significant digits. Non-finite values come back empty.
+std::string format_number(double value) {
+    if (!std::isfinite(value)) return "";
+    char buffer[32];
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        snprintf(buffer, sizeof(buffer), "%.0f", value);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%.10g", value);
+    }
+    return buffer;
+}
+
+void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char escape[8];
+                    snprintf(escape, sizeof(escape), "\\u%04x", c);
+                    out << escape;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+std::string csv_escape(const std::string& text) {
+    if (text.find_first_of(",\"\r\n") == std::string::npos) return text;
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Label values escape backslash, double quote and newline
+std::string label_escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '\\' || c == '"') escaped += '\\';
+        if (c == '\n') {
+            escaped += "\\n";
+            continue;
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string join_cpus(const std::vector<int>& cpus) {
+    std::string list;
+    for (size_t i = 0; i < cpus.size(); i++) {
+        if (i > 0) list += ' ';
+        list += std::to_string(cpus[i]);
+    }
+    return list;
+}
+
+// PCI ids as lspci prints them, e.g. 10de
+std::string hex_id(uint32_t value, int digits) {
+    char text[16];
+    snprintf(text, sizeof(text), "%0*x", digits, value);
+    return text;
+}
+
+} // namespace
+
+void JsonLinesWriter::begin(const char* record) {
+    out_ << "{\"type\":";
+    write_json_string(out_, record);
+    first_ = false;
+}
+
+void JsonLinesWriter::key(const char* name) {
+    if (!first_) out_ << ',';
+    first_ = false;
+    write_json_string(out_, name);
+    out_ << ':';
+}
+
+void JsonLinesWriter::field(const char* name, const std::string& value) {
+    key(name);
+    write_json_string(out_, value);
+}
+
+void JsonLinesWriter::field(const char* name, double value) {
+    key(name);
+    std::string number = format_number(value);
+    out_ << (number.empty() ? "null" : number);
+}
+
+void JsonLinesWriter::end() {
+    out_ << "}\n";
+}
+
+CsvWriter::CsvWriter(std::ostream& out) : out_(out) {
+    out_ << "record,key,metric,value\n";
+}
+
+void CsvWriter::begin(const char* record) {
+    record_ = record;
+    key_.clear();
+}
+
+void CsvWriter::id(const char* name, const std::string& value) {
+    if (!key_.empty()) key_ += ';';
+    key_ += std::string(name) + "=" + value;
+}
+
+void CsvWriter::id(const char* name, double value) {
+    id(name, format_number(value));
+}
+
+void CsvWriter::field(const char* name, const std::string& value) {
+    row(name, value);
+}
+
+void CsvWriter::field(const char* name, double value) {
+    row(name, format_number(value));
+}
+
+void CsvWriter::row(const char* metric, const std::string& value) {
+    out_ << record_ << ',' << csv_escape(key_) << ',' << metric << ',' << csv_escape(value) << '\n';
+}
+
+void OpenMetricsWriter::begin(const char* record) {
+    record_ = record;
+    labels_.clear();
+    info_labels_.clear();
+    values_.clear();
+    series_ = false;
+}
+
+void OpenMetricsWriter::id(const char* name, const std::string& value) {
+    std::string name_text = name;
+    if (name_text == "time_s" || name_text == "run") series_ = true;
+    if (!labels_.empty()) labels_ += ',';
+    labels_ += name_text + "=\"" + label_escape(value) + "\"";
+}
+
+void OpenMetricsWriter::id(const char* name, double value) {
+    id(name, format_number(value));
+}
+
+void OpenMetricsWriter::field(const char* name, const std::string& value) {
+    if (!info_labels_.empty()) info_labels_ += ',';
+    info_labels_ += std::string(name) + "=\"" + label_escape(value) + "\"";
+}
+
+void OpenMetricsWriter::field(const char* name, double value) {
+    values_.emplace_back(name, value);
+}
+
+void OpenMetricsWriter::end() {
+    if (series_) return;
+    std::string base = "pctester_" + record_;
+    std::string labels = labels_.empty() ? "" : "{" + labels_ + "}";
+    for (const auto& value : values_) {
+        std::string number = format_number(value.second);
+        if (number.empty()) number = "NaN";
+        family(base + "_" + value.first, false).samples.push_back(base + "_" + value.first + labels + " " + number);
+    }
+    if (!info_labels_.empty()) {
+        std::string all = labels_.empty() ? info_labels_ : labels_ + "," + info_labels_;
+        family(base, true).samples.push_back(base + "_info{" + all + "} 1");
+    }
+}
+
+OpenMetricsWriter::Family& OpenMetricsWriter::family(const std::string& name, bool info) {
+    auto it = family_index_.find(name);
+    if (it != family_index_.end()) return families_[it->second];
+    family_index_[name] = families_.size();
+    families_.push_back({ name, info, {} });
+    return families_.back();
+}
+
+std::string OpenMetricsWriter::text() const {
+    std::string out;
+    for (const Family& family : families_) {
+        out += "# TYPE " + family.name + (family.info ? " info\n" : " gauge\n");
+        for (const std::string& sample : family.samples) out += sample + "\n";
+    }
+    return out;
+}
+
+void write_results(ResultWriter& w, const SystemInfo& info, const TestResults& r) {
+    w.begin("system");
+    w.field("os", info.os_name);
+    w.field("cpu", info.cpu_name);
+    w.field("cpu_sockets", static_cast<double>(info.cpu_sockets));
+    w.field("cpu_cores", static_cast<double>(info.cpu_cores));
+    w.field("cpu_threads", static_cast<double>(info.cpu_threads));
+    w.field("memory_bytes", static_cast<double>(info.memory_size));
+    w.field("gpu", info.gpu_name);
+    w.field("gpu_memory_mb", static_cast<double>(info.gpu_memory));
+    w.end();
+    for (const auto& disk : info.disk_names) {
+        w.begin("disk_device");
+        w.id("name", disk);
+        w.end();
+    }
+    for (const auto& cache : info.caches) {
+        w.begin("cache");
+        w.id("level", cache.level);
+        w.id("cache_type", cache.type);
+        w.field("size_bytes", static_cast<double>(cache.size));
+        w.field("line_size", static_cast<double>(cache.line_size));
+        w.field("shared_cpus", cache.shared_cpus);
+        w.end();
+    }
+    for (const auto& node : info.numa_nodes) {
+        w.begin("numa_node");
+        w.id("node", node.id);
+        w.field("cpus", join_cpus(node.cpus));
+        w.field("memory_bytes", static_cast<double>(node.memory_size));
+        w.end();
+    }
+    // Locators can be blank or repeated in firmware tables, so the slot's
+    // position keeps every DIMM's labels unique
+    for (size_t i = 0; i < info.dimms.size(); i++) {
+        const auto& dimm = info.dimms[i];
+        w.begin("dimm");
+        w.id("slot", static_cast<double>(i));
+        w.id("locator", dimm.locator);
+        w.field("size_bytes", static_cast<double>(dimm.size));
+        w.field("memory_type", dimm.type);
+        w.field("speed_mts", static_cast<double>(dimm.speed_mts));
+        w.field("manufacturer", dimm.manufacturer);
+        w.field("part_number", dimm.part_number);
+        w.end();
+    }
+    for (const auto& device : info.pci_devices) {
+        w.begin("pci_device");
+        w.id("address", device.address);
+        w.field("class", hex_id(device.class_code, 6));
+        w.field("vendor_id", hex_id(device.vendor_id, 4));
+        w.field("device_id", hex_id(device.device_id, 4));
+        w.field("name", device.name);
+        w.field("driver", device.driver);
+        w.end();
+    }
+
+    w.begin("summary");
+    w.field("cpu_score", r.cpu_score);
+    w.field("cpu_single_score", r.cpu_single_score);
+    w.field("cpu_multi_score", r.cpu_multi_score);
+    w.field("cpu_scaling_efficiency", r.cpu_scaling_efficiency);
+    w.field("cpu_core_composite", r.cpu_core_composite);
+    w.field("cpu_temp_c", r.cpu_temp);
+    w.field("ram_score_gbs", r.ram_score);
+    w.field("ram_usage_pct", r.ram_usage);
+    w.field("ram_latency_ns", r.ram_latency_ns);
+    w.field("disk_engine", r.disk_engine);
+    w.field("disk_read_mbps", r.disk_read);
+    w.field("disk_write_mbps", r.disk_write);
+    w.field("network_target", r.network_target);
+    w.field("network_streams", r.network_streams);
+    w.field("network_bandwidth_mbits", r.network_bandwidth);
+    w.field("network_rtt_p50_us", r.network_latency);
+    w.field("network_rtt_p99_us", r.network_rtt_p99_us);
+    w.field("network_rtt_p999_us", r.network_rtt_p999_us);
+    w.field("network_udp_pps", r.network_udp_pps);
+    w.field("network_udp_loss_pct", r.network_udp_loss);
+    w.field("network_stress_connections", r.network_stress_connections);
+    w.field("network_stress_rps", r.network_stress_rps);
+    w.field("network_stress_p50_us", r.network_stress_p50_us);
+    w.field("network_stress_p99_us", r.network_stress_p99_us);
+    w.field("network_stress_p999_us", r.network_stress_p999_us);
+    w.field("network_stress_balance", r.network_stress_balance);
+    w.field("gpu_score", r.gpu_score);
+    w.field("gpu_engine", r.gpu_engine);
+    w.field("gpu_triangles_mps", r.gpu_triangle_rate);
+    w.field("gpu_fill_gpixs", r.gpu_fill_rate);
+    w.field("gpu_compute_gpixs", r.gpu_compute_rate);
+    w.field("telemetry_period_ms", r.telemetry_period_ms);
+    w.field("nominal_freq_mhz", r.nominal_freq_mhz);
+    w.field("thermal_limit_c", r.thermal_limit_c);
+    w.end();
+
+    for (const auto& core : r.cpu_core_scores) {
+        w.begin("cpu_core");
+        w.id("cpu", core.first);
+        w.field("score", core.second);
+        w.end();
+    }
+    for (const auto& workload : r.cpu_workload_scores) {
+        w.begin("cpu_workload");
+        w.id("name", workload.name);
+        w.field("unit", workload.unit);
+        w.field("engine", workload.engine);
+        w.field("rate", workload.rate);
+        w.field("score", workload.score);
+        w.field("weight", workload.weight);
+        w.end();
+    }
+    for (const auto& slice : r.cpu_score_timeline) {
+        w.begin("cpu_score_slice");
+        w.id("time_s", slice.first);
+        w.field("score", slice.second);
+        w.end();
+    }
+    for (const auto& simd : r.simd_scores) {
+        w.begin("simd");
+        w.id("isa", simd.isa);
+        w.field("fma_gflops", simd.fma_gflops);
+        w.field("dot_gflops", simd.dot_gflops);
+        w.field("saxpy_gbs", simd.saxpy_gbs);
+        w.field("hash_gops", simd.hash_gops);
+        w.end();
+    }
+    for (const auto& stream : r.stream_results) {
+        w.begin("stream");
+        w.id("threads", static_cast<double>(stream.threads));
+        w.field("copy_gbs", stream.copy_gbs);
+        w.field("scale_gbs", stream.scale_gbs);
+        w.field("add_gbs", stream.add_gbs);
+        w.field("triad_gbs", stream.triad_gbs);
+        w.end();
+    }
+    for (const auto& point : r.latency_curve) {
+        w.begin("latency");
+        w.id("working_set_bytes", static_cast<double>(point.first));
+        w.field("ns", point.second);
+        w.end();
+    }
+    for (size_t level = 0; level < r.detected_cache_sizes.size(); level++) {
+        w.begin("cache_detected");
+        w.id("level", static_cast<double>(level + 1));
+        w.field("size_bytes", static_cast<double>(r.detected_cache_sizes[level]));
+        w.end();
+    }
+    for (size_t cpu_node = 0; cpu_node < r.numa_bandwidth_gbs.size(); cpu_node++) {
+        for (size_t mem_node = 0; mem_node < r.numa_bandwidth_gbs[cpu_node].size(); mem_node++) {
+            w.begin("numa");
+            w.id("cpu_node", cpu_node < info.numa_nodes.size() ? info.numa_nodes[cpu_node].id : static_cast<double>(cpu_node));
+            w.id("mem_node", mem_node < info.numa_nodes.size() ? info.numa_nodes[mem_node].id : static_cast<double>(mem_node));
+            w.field("bandwidth_gbs", r.numa_bandwidth_gbs[cpu_node][mem_node]);
+            if (cpu_node < r.numa_latency_ns.size() && mem_node < r.numa_latency_ns[cpu_node].size()) {
+                w.field("latency_ns", r.numa_latency_ns[cpu_node][mem_node]);
+            }
+            w.end();
+        }
+    }
+    for (const auto& disk : r.disk_profiles) {
+        w.begin("disk_profile");
+        w.id("profile", disk.name);
+        w.field("block_size", static_cast<double>(disk.block_size));
+        w.field("queue_depth", disk.queue_depth);
+        w.field("mbps", disk.mbps);
+        w.field("iops", disk.iops);
+        w.field("p50_us", disk.p50_us);
+        w.field("p99_us", disk.p99_us);
+        w.field("p999_us", disk.p999_us);
+        w.end();
+    }
+    for (const auto& sync : r.disk_sync_results) {
+        w.begin("disk_sync");
+        w.id("mode", sync.mode);
+        w.field("write_size", static_cast<double>(sync.write_size));
+        w.field("count", static_cast<double>(sync.count));
+        w.field("mean_us", sync.mean_us);
+        w.field("p50_us", sync.p50_us);
+        w.field("p90_us", sync.p90_us);
+        w.field("p99_us", sync.p99_us);
+        w.field("p999_us", sync.p999_us);
+        w.field("max_us", sync.max_us);
+        w.end();
+        for (const auto& bucket : sync.buckets) {
+            w.begin("disk_sync_bucket");
+            w.id("mode", sync.mode);
+            w.id("upper_us", bucket.first);
+            w.field("count", static_cast<double>(bucket.second));
+            w.end();
+        }
+    }
+    for (const auto& mmap : r.mmap_results) {
+        w.begin("mmap");
+        w.id("pattern", mmap.pattern);
+        w.id("hint", mmap.hint);
+        w.id("access", mmap.write ? "write" : "read");
+        w.field("mbps", mmap.mbps);
+        w.field("seconds", mmap.seconds);
+        w.field("map_seconds", mmap.map_seconds);
+        w.field("minor_faults", static_cast<double>(mmap.minor_faults));
+        w.field("major_faults", static_cast<double>(mmap.major_faults));
+        w.field("huge_page_kb", mmap.huge_page_kb);
+        w.end();
+    }
+    for (const auto& loop : r.network_stress_loops) {
+        w.begin("network_loop");
+        w.id("cpu", loop.cpu);
+        w.field("connections", loop.connections);
+        w.field("requests_per_sec", loop.requests_per_sec);
+        w.end();
+    }
+
+    for (const auto& stats : r.bench_stats) {
+        w.begin("benchmark");
+        w.id("name", stats.name);
+        w.field("unit", stats.unit);
+        w.field("median", stats.median);
+        w.field("mean", stats.mean);
+        w.field("min", stats.min);
+        w.field("max", stats.max);
+        w.field("stddev", stats.stddev);
+        w.field("ci95_low", stats.ci95_low);
+        w.field("ci95_high", stats.ci95_high);
+        w.field("rse_pct", stats.rse_pct);
+        w.field("warmup_runs", stats.warmup_runs);
+        w.field("runs", stats.runs);
+        w.field("outliers", stats.outliers);
+        w.field("converged", stats.converged ? 1.0 : 0.0);
+        w.end();
+        for (size_t run = 0; run < stats.samples.size(); run++) {
+            w.begin("benchmark_run");
+            w.id("name", stats.name);
+            w.id("run", static_cast<double>(run));
+            w.field("value", stats.samples[run]);
+            w.end();
+        }
+    }
+    for (const auto& delta : r.baseline_deltas) {
+        w.begin("baseline_delta");
+        w.id("name", delta.name);
+        w.field("unit", delta.unit);
+        w.field("baseline", delta.baseline);
+        w.field("current", delta.current);
+        w.field("delta_pct", delta.delta_pct);
+        w.field("ci95_low_pct", delta.ci95_low_pct);
+        w.field("ci95_high_pct", delta.ci95_high_pct);
+        w.field("verdict", delta.verdict);
+        w.end();
+    }
+    for (const auto& entry : r.perf_counters) {
+        const PerfCounters& counters = entry.second;
+        if (!counters.available) continue;
+        w.begin("perf_counters");
+        w.id("stage", entry.first);
+        w.field("scope", counters.per_cpu ? "cpus" : "threads");
+        w.field("partial", counters.partial ? 1.0 : 0.0);
+        w.field("overlapped", counters.overlapped ? 1.0 : 0.0);
+        w.field("seconds", counters.seconds);
+        w.field("cycles", counters.cycles);
+        w.field("instructions", counters.instructions);
+        w.field("ipc", counters.ipc);
+        w.field("llc_misses", counters.llc_misses);
+        w.field("branch_misses", counters.branch_misses);
+        w.field("dtlb_misses", counters.dtlb_misses);
+        w.end();
+    }
+    // One stage can throttle more than once for the same cause
+    for (size_t i = 0; i < r.throttle_events.size(); i++) {
+        const auto& event = r.throttle_events[i];
+        w.begin("throttle");
+        w.id("event", static_cast<double>(i));
+        w.id("stage", event.phase);
+        w.id("cause", event.cause);
+        w.field("onset_s", event.onset_s);
+        w.field("duration_s", event.duration_s);
+        w.field("perf_loss_pct", event.perf_loss_pct);
+        w.end();
+    }
+
+    for (const auto& phase : r.telemetry_phases) {
+        w.begin("telemetry_phase");
+        w.id("stage", phase.name);
+        w.field("start_s", phase.start_s);
+        w.field("end_s", phase.end_s);
+        w.field("samples", static_cast<double>(phase.samples.size()));
+        w.end();
+        for (const auto& core : phase.core_freq_mhz) {
+            w.begin("telemetry_core_freq");
+            w.id("stage", phase.name);
+            w.id("cpu", core.first);
+            w.field("mean_mhz", core.second);
+            w.end();
+        }
+        for (const auto& sample : phase.samples) {
+            w.begin("telemetry_sample");
+            w.id("stage", phase.name);
+            w.id("time_s", sample.time_s);
+            w.field("cpu_temp_c", sample.cpu_temp_c);
+            w.field("gpu_temp_c", sample.gpu_temp_c);
+            w.field("cpu_util_pct", sample.cpu_util_pct);
+            w.field("freq_avg_mhz", sample.freq_avg_mhz);
+            w.field("freq_min_mhz", sample.freq_min_mhz);
+            w.field("freq_max_mhz", sample.freq_max_mhz);
+            w.field("package_power_w", sample.package_power_w);
+            w.end();
+        }
+    }
+}
+
+bool export_results_file(const std::string& filename, ResultFormat format,
+                         const SystemInfo& info, const TestResults& results) {
+    std::ofstream file(filename);
+    if (!file.is_open()) return false;
+    if (format == ResultFormat::Csv) {
+        CsvWriter writer(file);
+        write_results(writer, info, results);
+    } else {
+        JsonLinesWriter writer(file);
+        write_results(writer, info, results);
+    }
+    file.flush();
+    return file.good();
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "PCTester.h"
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Receives results one flat record at a time, so a serializer never holds
+// more than the record it is writing. Identity fields say which thing a
+// record describes (a CPU id, an ISA, a stage); the rest are measurements.
+class ResultWriter {
+public:
+    virtual ~ResultWriter() = default;
+    virtual void begin(const char* record) = 0;
+    virtual void id(const char* name, const std::string& value) = 0;
+    virtual void id(const char* name, double value) = 0;
+    virtual void field(const char* name, const std::string& value) = 0;
+    virtual void field(const char* name, double value) = 0;
+    virtual void end() = 0;
+};
+
+// One JSON object per line: {"type":"simd","isa":"AVX2","fma_gflops":20.4,...}
+class JsonLinesWriter : public ResultWriter {
+public:
+    explicit JsonLinesWriter(std::ostream& out) : out_(out), first_(true) {}
+    void begin(const char* record) override;
+    void id(const char* name, const std::string& value) override { field(name, value); }
+    void id(const char* name, double value) override { field(name, value); }
+    void field(const char* name, const std::string& value) override;
+    void field(const char* name, double value) override;
+    void end() override;
+    
+private:
+    void key(const char* name);
+    
+    std::ostream& out_;
+    bool first_;
+};
+
+// Long-format CSV, one row per measurement: record,key,metric,value where
+// key joins the record's identity fields, e.g. simd,isa=AVX2,fma_gflops,20.4
+class CsvWriter : public ResultWriter {
+public:
+    explicit CsvWriter(std::ostream& out);
+    void begin(const char* record) override;
+    void id(const char* name, const std::string& value) override;
+    void id(const char* name, double value) override;
+    void field(const char* name, const std::string& value) override;
+    void field(const char* name, double value) override;
+    void end() override {}
+    
+private:
+    void row(const char* metric, const std::string& value);
+    
+    std::ostream& out_;
+    std::string record_;
+    std::string key_;
+};
+
+// OpenMetrics text exposition. Each numeric field becomes a gauge named
+// pctester_<record>_<field> labelled with the record's identity fields,
+// and a record's string fields become one pctester_<record>_info sample.
+// Samples are grouped into families, as the format requires, when text()
+// is called. Records keyed by time_s or run number are per-sample series
+// and are left out; a scraper builds time series itself.
+class OpenMetricsWriter : public ResultWriter {
+public:
+    void begin(const char* record) override;
+    void id(const char* name, const std::string& value) override;
+    void id(const char* name, double value) override;
+    void field(const char* name, const std::string& value) override;
+    void field(const char* name, double value) override;
+    void end() override;
+    
+    // Every family written so far, without the closing "# EOF"
+    std::string text() const;
+    
+private:
+    struct Family {
+        std::string name;
+        bool info;
+        std::vector<std::string> samples;
+    };
+    
+    Family& family(const std::string& name, bool info);
+    
+    std::string record_;
+    std::string labels_;
+    std::string info_labels_;
+    std::vector<std::pair<std::string, double>> values_;
+    bool series_ = false;
+    std::vector<Family> families_;
+    std::map<std::string, size_t> family_index_;
+};
+
+// Walks SystemInfo and TestResults, including every benchmark run and the
+// telemetry time series, and hands each record to writer
+void write_results(ResultWriter& writer, const SystemInfo& info, const TestResults& results);
+
+// Opens filename and streams everything in the given format; false if the
+// file cannot be written
+bool export_results_file(const std::string& filename, ResultFormat format,
+                         const SystemInfo& info, const TestResults& results);
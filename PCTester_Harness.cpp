@@ -0,0 +1,97 @@
+#include "PCTester_Harness.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+// Two-sided 95% Student's t quantiles for 1-30 degrees of freedom
+const double kStudentT95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+// Iglewicz and Hoaglin's cut-off for the modified z-score
+const double kOutlierScore = 3.5;
+
+double median_of(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+}
+
+} // namespace
+
+double student_t95(size_t degrees) {
+    if (degrees == 0) return 0.0;
+    if (degrees <= sizeof(kStudentT95) / sizeof(kStudentT95[0])) return kStudentT95[degrees - 1];
+    return 1.96;
+}
+
+BenchmarkOptions BenchmarkOptions::from(const TestConfig& config) {
+    BenchmarkOptions options;
+    options.warmup_runs = std::max(0, config.bench_warmup_runs);
+    options.min_runs = std::max(2, config.bench_min_runs);
+    options.max_runs = std::max(options.min_runs, config.bench_max_runs);
+    options.target_rse_pct = config.bench_target_rse_pct;
+    options.max_seconds = config.bench_max_seconds;
+    return options;
+}
+
+BenchmarkStats summarize_samples(const std::string& name, const std::string& unit, std::vector<double> samples) {
+    BenchmarkStats stats{};
+    stats.name = name;
+    stats.unit = unit;
+    stats.runs = static_cast<int>(samples.size());
+    if (samples.empty()) return stats;
+    
+    // 1.4826 scales the MAD to a standard deviation for normal data. A zero
+    // MAD (most samples identical) would flag everything else, so it
+    // disables rejection instead.
+    double median = median_of(samples);
+    std::vector<double> deviations;
+    for (double sample : samples) deviations.push_back(std::fabs(sample - median));
+    double mad = 1.4826 * median_of(deviations);
+    std::vector<double> kept;
+    for (double sample : samples) {
+        if (mad > 0.0 && std::fabs(sample - median) / mad > kOutlierScore) continue;
+        kept.push_back(sample);
+    }
+    stats.outliers = static_cast<int>(samples.size() - kept.size());
+    
+    size_t n = kept.size();
+    double sum = 0.0;
+    for (double sample : kept) sum += sample;
+    stats.mean = sum / n;
+    stats.median = median_of(kept);
+    stats.min = *std::min_element(kept.begin(), kept.end());
+    stats.max = *std::max_element(kept.begin(), kept.end());
+    
+    double squares = 0.0;
+    for (double sample : kept) squares += (sample - stats.mean) * (sample - stats.mean);
+    stats.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+    
+    // A single sample says nothing about its own spread
+    double standard_error = stats.stddev / std::sqrt(static_cast<double>(n));
+    stats.rse_pct = n > 1 && stats.mean != 0.0 ? 100.0 * standard_error / std::fabs(stats.mean) : 100.0;
+    double half_width = student_t95(n - 1) * standard_error;
+    stats.ci95_low = stats.mean - half_width;
+    stats.ci95_high = stats.mean + half_width;
+    stats.samples = std::move(samples);
+    return stats;
+}
+
+std::string format_stats(const BenchmarkStats& stats) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << stats.median << " " << stats.unit << " +/-" << std::setprecision(1) << stats.rse_pct << "%"
+       << std::setprecision(2) << " (95% CI " << stats.ci95_low << "-" << stats.ci95_high << ", n=" << stats.runs;
+    if (stats.outliers > 0) ss << ", " << stats.outliers << " outlier" << (stats.outliers > 1 ? "s" : "");
+    ss << ")";
+    if (!stats.converged) ss << " [not converged]";
+    return ss.str();
+}
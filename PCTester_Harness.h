@@ -0,0 +1,61 @@
+#pragma once
+
+#include "PCTester.h"
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Repetition policy for one measurement, taken from TestConfig
+struct BenchmarkOptions {
+    int warmup_runs;
+    int min_runs;
+    int max_runs;
+    double target_rse_pct;  // stop once the mean's relative standard error is this small
+    double max_seconds;     // wall-clock cap including warmup
+    
+    static BenchmarkOptions from(const TestConfig& config);
+};
+
+// Two-sided 95% quantile of Student's t; 1.96 beyond 30 degrees of freedom
+double student_t95(size_t degrees);
+
+// Rejects outliers (modified z-score above 3.5, i.e. more than 3.5 scaled
+// median absolute deviations from the median) and computes the summary
+// over the rest. The confidence interval uses Student's t.
+BenchmarkStats summarize_samples(const std::string& name, const std::string& unit, std::vector<double> samples);
+
+// "912.4 Mterms/s +/-0.6% (95% CI 905.1-919.7, n=7, 1 outlier)"
+std::string format_stats(const BenchmarkStats& stats);
+
+// Calls kernel (which returns one measurement, e.g. a rate) for the
+// warmup runs, then repeatedly until the relative standard error of the
+// kept samples reaches the target or a run or time cap is hit.
+template<typename F>
+BenchmarkStats run_benchmark(const std::string& name, const std::string& unit,
+                             const BenchmarkOptions& options, F&& kernel) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    
+    int warmup = 0;
+    for (; warmup < options.warmup_runs && elapsed() < options.max_seconds; warmup++) kernel();
+    
+    std::vector<double> samples;
+    samples.reserve(options.max_runs);
+    BenchmarkStats stats{};
+    do {
+        samples.push_back(kernel());
+        if (static_cast<int>(samples.size()) < options.min_runs && elapsed() < options.max_seconds) continue;
+        stats = summarize_samples(name, unit, samples);
+        if (static_cast<int>(samples.size()) >= options.min_runs && stats.rse_pct <= options.target_rse_pct) {
+            stats.converged = true;
+            break;
+        }
+    } while (static_cast<int>(samples.size()) < options.max_runs && elapsed() < options.max_seconds);
+    
+    if (stats.runs != static_cast<int>(samples.size())) stats = summarize_samples(name, unit, std::move(samples));
+    stats.warmup_runs = warmup;
+    return stats;
+}
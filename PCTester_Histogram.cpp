@@ -0,0 +1,109 @@
+#include "PCTester_Histogram.h"
+#include <algorithm>
+#include <limits>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+static int highest_bit(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+LatencyHistogram::LatencyHistogram(int precision_bits)
+    : precision_bits_(precision_bits),
+      half_(1ull << (precision_bits - 1)),
+      counts_((1ull << precision_bits) + (64 - precision_bits) * (1ull << (precision_bits - 1)), 0),
+      total_(0),
+      min_(std::numeric_limits<uint64_t>::max()),
+      max_(0),
+      sum_(0.0) {}
+
+// Values below 2^precision_bits map 1:1. Above that, each power of two is
+// split into half_ equal sub-buckets.
+size_t LatencyHistogram::index_of(uint64_t value) const {
+    if (value < (1ull << precision_bits_)) return static_cast<size_t>(value);
+    int shift = highest_bit(value) - (precision_bits_ - 1);
+    uint64_t sub = value >> shift;
+    return static_cast<size_t>((1ull << precision_bits_) + (shift - 1) * half_ + (sub - half_));
+}
+
+uint64_t LatencyHistogram::upper_edge(size_t index) const {
+    if (index < (1ull << precision_bits_)) return index;
+    uint64_t k = index - (1ull << precision_bits_);
+    int shift = static_cast<int>(k / half_) + 1;
+    uint64_t sub = k % half_ + half_;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    counts_[index_of(value)]++;
+    total_++;
+    sum_ += static_cast<double>(value);
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.precision_bits_ != precision_bits_) {
+        // Different layouts: re-record each bucket at its upper edge
+        for (size_t i = 0; i < other.counts_.size(); i++) {
+            uint64_t value = other.upper_edge(i);
+            counts_[index_of(value)] += other.counts_[i];
+        }
+    } else {
+        for (size_t i = 0; i < counts_.size(); i++) counts_[i] += other.counts_[i];
+    }
+    total_ += other.total_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_ = 0;
+    sum_ = 0.0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+}
+
+double LatencyHistogram::mean() const {
+    return total_ ? sum_ / total_ : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    if (total_ == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(q * total_);
+    if (rank >= total_) rank = total_ - 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+        seen += counts_[i];
+        if (seen > rank) return std::min(upper_edge(i), max_);
+    }
+    return max_;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> LatencyHistogram::log2_buckets() const {
+    std::vector<std::pair<uint64_t, uint64_t>> buckets;
+    if (total_ == 0) return buckets;
+    int first = min_ ? highest_bit(min_) : 0;
+    int last = max_ ? highest_bit(max_) : 0;
+    for (int bit = first; bit <= last; bit++) {
+        uint64_t upper = bit == 63 ? std::numeric_limits<uint64_t>::max() : (2ull << bit) - 1;
+        buckets.emplace_back(upper, 0);
+    }
+    for (size_t i = 0; i < counts_.size(); i++) {
+        if (counts_[i] == 0) continue;
+        uint64_t edge = upper_edge(i);
+        int bit = edge ? highest_bit(edge) : 0;
+        buckets[std::min<size_t>(std::max(bit - first, 0), buckets.size() - 1)].second += counts_[i];
+    }
+    return buckets;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// HDR-style latency histogram. Buckets are linear up to 2^precision_bits
+// and log-linear above that, so every recorded value keeps a relative
+// error below 1 / 2^(precision_bits - 1) across the full 64-bit range
+// with a fixed, small footprint. Recording is O(1) and allocation-free,
+// which makes it safe to use inside timed loops.
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(int precision_bits = 7);
+
+    void record(uint64_t value);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const { return total_; }
+    uint64_t min() const { return total_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const;
+
+    // Smallest bucket upper edge at or below which a fraction q of values lie
+    uint64_t percentile(double q) const;
+
+    // Counts folded into power-of-two ranges as (upper bound, count) pairs,
+    // for compact reports and charts
+    std::vector<std::pair<uint64_t, uint64_t>> log2_buckets() const;
+
+private:
+    size_t index_of(uint64_t value) const;
+    uint64_t upper_edge(size_t index) const;
+
+    int precision_bits_;
+    uint64_t half_;
+    std::vector<uint64_t> counts_;
+    uint64_t total_;
+    uint64_t min_;
+    uint64_t max_;
+    double sum_;
+};
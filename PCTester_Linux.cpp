@@ -1,116 +1,274 @@
 #include "PCTester_Linux.h"
+#include "PCTester_SIMD.h"
+#include "PCTester_Raster.h"
+#include "PCTester_Workloads.h"
+#include "PCTester_Linux_Perf.h"
+#include "PCTester_Harness.h"
+#include "PCTester_Export.h"
+#include "PCTester_Baseline.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <chrono>
 #include <thread>
 #include <random>
-#include <cstring>
 #include <sys/statvfs.h>
-#include <sys/sysinfo.h>
 #include <sys/types.h>
-#include <dirent.h>
 
-PCTester::Impl::Impl() {
+// Samples kept by the telemetry ring: 13 minutes at the default 50 ms
+static const size_t kTelemetryCapacity = 16384;
+
+PCTester::Impl::Impl(const TestConfig& config)
+    : config(config), telemetry(online_cpus(), kTelemetryCapacity) {
     collect_system_info();
+    if (config.metrics_port) start_metrics();
 }
 
-void PCTester::Impl::collect_system_info() {
-    // Get OS info
-    std::ifstream os_release("/etc/os-release");
-    if (os_release.is_open()) {
-        std::string line;
-        while (std::getline(os_release, line)) {
-            if (line.find("PRETTY_NAME") != std::string::npos) {
-                size_t pos = line.find('=');
-                if (pos != std::string::npos) {
-                    sys_info.os_name = line.substr(pos + 1);
-                    // Remove quotes
-                    sys_info.os_name.erase(
-                        std::remove(sys_info.os_name.begin(), sys_info.os_name.end(), '"'),
-                        sys_info.os_name.end()
-                    );
-                }
-            }
+const std::vector<PCTester::Impl::Stage>& PCTester::Impl::stages() {
+    static const std::vector<Stage> all = {
+        { "CPU", &Impl::cpu_benchmark, false, false }, { "SIMD", &Impl::simd_benchmark, false, false },
+        { "RAM", &Impl::ram_test, false, false }, { "Latency", &Impl::ram_latency_test, false, false },
+        { "NUMA", &Impl::numa_test, false, false }, { "Disk", &Impl::disk_test, true, false },
+        { "Mmap", &Impl::mmap_test, true, false }, { "Network", &Impl::network_test, false, false },
+        { "GPU", &Impl::gpu_benchmark, false, true }
+    };
+    return all;
+}
+
+std::vector<std::string> PCTester::Impl::stage_names() {
+    std::vector<std::string> names;
+    for (const Stage& stage : stages()) names.push_back(stage.name);
+    return names;
+}
+
+// Widens the calling thread to the process's affinity mask for its
+// lifetime and restores the previous mask afterwards. Threads inherit
+// their creator's mask, so a stage run on a pinned scheduler worker would
+// otherwise confine every I/O and network thread it starts to one CPU.
+// Workloads that want pinning still pin their own threads.
+class ProcessAffinityScope {
+public:
+    ProcessAffinityScope() {
+        CPU_ZERO(&saved_);
+        restore_ = sched_getaffinity(0, sizeof(saved_), &saved_) == 0;
+        cpu_set_t process;
+        CPU_ZERO(&process);
+        if (restore_ && sched_getaffinity(getpid(), sizeof(process), &process) == 0) {
+            sched_setaffinity(0, sizeof(process), &process);
         }
     }
+    ~ProcessAffinityScope() {
+        if (restore_) sched_setaffinity(0, sizeof(saved_), &saved_);
+    }
+    ProcessAffinityScope(const ProcessAffinityScope&) = delete;
+    ProcessAffinityScope& operator=(const ProcessAffinityScope&) = delete;
     
-    // Get CPU info
-    std::ifstream cpuinfo("/proc/cpuinfo");
-    if (cpuinfo.is_open()) {
-        std::string line;
-        int cores = 0;
-        while (std::getline(cpuinfo, line)) {
-            if (line.find("model name") != std::string::npos) {
-                size_t pos = line.find(':');
-                if (pos != std::string::npos) {
-                    sys_info.cpu_name = line.substr(pos + 2);
-                }
-            }
-            if (line.find("cpu cores") != std::string::npos) {
-                size_t pos = line.find(':');
-                if (pos != std::string::npos) {
-                    sys_info.cpu_cores = std::stoi(line.substr(pos + 2));
-                }
-            }
-            if (line.find("siblings") != std::string::npos) {
-                size_t pos = line.find(':');
-                if (pos != std::string::npos) {
-                    sys_info.cpu_threads = std::stoi(line.substr(pos + 2));
-                }
-            }
+private:
+    cpu_set_t saved_;
+    bool restore_;
+};
+
+void PCTester::Impl::run_stages(const std::vector<std::string>& names) {
+    SafeOutput::print("\n=== Advanced Diagnostics ===");
+    
+    // Start telemetry sampling
+    SafeOutput::print("[MONITOR] Starting telemetry sampling...");
+    telemetry.start(config.telemetry_period_ms);
+    test_results.throttle_events.clear();
+    test_results.bench_stats.clear();
+    
+    // Run tests. Every stage is a scheduler task; each lane runs its
+    // stages in order, and with pipeline_stages the lanes overlap. Each
+    // stage is a telemetry phase so its samples end up in the report.
+    std::vector<const Stage*> compute;
+    std::vector<const Stage*> storage;
+    for (const Stage& stage : stages()) {
+        if (std::find(names.begin(), names.end(), stage.name) == names.end()) continue;
+        (config.pipeline_stages && stage.storage ? storage : compute).push_back(&stage);
+    }
+    // Hardware counters are opened on the worker that runs the stage and
+    // inherited by the threads the stage starts, and the worker's pin is
+    // lifted for the stage so those threads can spread across the process's
+    // CPUs. Workers already exist, so
+    // a stage that runs tasks on them is counted per CPU instead, when the
+    // kernel allows it, and flagged partial when it does not. While the
+    // storage lane runs beside it, per-CPU counts would take in that lane
+    // and the telemetry sampler too, so such a stage falls back to its own
+    // threads and is flagged partial and overlapped. Every key is inserted
+    // up front so concurrent lanes only ever assign to existing entries.
+    bool overlapped = !storage.empty();
+    auto run_stage = [this, overlapped](const Stage* stage) {
+        std::unique_ptr<PerfCounterGroup> counters;
+        if (stage->workers && !overlapped) counters = std::make_unique<PerfCounterGroup>(online_cpus());
+        if (!counters || !counters->available()) counters = std::make_unique<PerfCounterGroup>();
+        counters->start();
+        {
+            ProcessAffinityScope affinity;
+            (this->*stage->run)();
+        }
+        PerfCounters result = counters->stop();
+        result.partial = stage->workers && !result.per_cpu;
+        result.overlapped = stage->workers && overlapped;
+        test_results.perf_counters.at(stage->name) = result;
+    };
+    auto run_lane = [this, &run_stage](const std::vector<const Stage*>& lane) {
+        for (const Stage* stage : lane) {
+            telemetry.begin_phase(stage->name);
+            scheduler.submit(run_stage, stage).get();
+            telemetry.end_phase(stage->name);
+            report_counters(stage->name);
+            // A pipelined lane would read results the other lane is writing
+            if (!config.pipeline_stages) publish_metrics();
         }
+    };
+    test_results.perf_counters.clear();
+    for (const Stage* stage : compute) test_results.perf_counters[stage->name];
+    for (const Stage* stage : storage) test_results.perf_counters[stage->name];
+    if (!storage.empty()) {
+        Future<void> storage_done = scheduler.submit(run_lane, storage);
+        run_lane(compute);
+        storage_done.get();
+    } else {
+        run_lane(compute);
     }
     
-    // Get memory info
-    struct sysinfo memInfo;
-    sysinfo(&memInfo);
-    sys_info.memory_size = memInfo.totalram * memInfo.mem_unit;
-    
-    // Get GPU info (simplified)
-    FILE* pipe = popen("lspci | grep VGA", "r");
-    if (pipe) {
-        char buffer[128];
-        if (fgets(buffer, 128, pipe) != NULL) {
-            // Skip the first 8 characters (bus ID)
-            char* gpu_name = buffer + 8;
-            // Remove newline
-            char* newline = strchr(gpu_name, '\n');
-            if (newline) *newline = 0;
-            sys_info.gpu_name = gpu_name;
+    // Stop sampling
+    telemetry.stop();
+    test_results.telemetry_period_ms = std::min(std::max(config.telemetry_period_ms, 10.0), 100.0);
+    test_results.telemetry_phases = telemetry.phases();
+    SafeOutput::print("[MONITOR] Telemetry sampling stopped");
+    report_throttling();
+    publish_metrics();
+    
+    SafeOutput::print("\nAll tests completed!");
+}
+
+// Basel-series terms summed per worker between deadline checks
+static const uint64_t kCpuChunkTerms = 1 << 20;
+
+static double basel_chunk(uint64_t first, uint64_t count) {
+    double sum = 0.0;
+    for (uint64_t i = first; i < first + count; i++) {
+        double x = static_cast<double>(i);
+        sum += 1.0 / (x * x);
+    }
+    return sum;
+}
+
+std::vector<int> PCTester::Impl::online_cpus() const {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    // Stages run on pinned scheduler workers, so ask for the main thread's
+    // mask (pid == tid of the main thread) rather than the calling thread's
+    if (sched_getaffinity(getpid(), sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
         }
-        pclose(pipe);
     }
-    
-    // Get GPU memory (simulated)
-    sys_info.gpu_memory = 4096; // 4GB default
+    if (cpus.empty()) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < std::max(1L, n); cpu++) cpus.push_back(static_cast<int>(cpu));
+    }
+    return cpus;
 }
 
-void PCTester::Impl::run_full_diagnostics() {
-    SafeOutput::print("\n=== Advanced Diagnostics ===");
-    
-    // Start temperature monitoring
-    std::atomic<bool> stop_monitoring(false);
-    std::thread temp_monitor(&Impl::monitor_temperatures, this, std::ref(stop_monitoring));
+std::vector<int> PCTester::Impl::worker_cpus() const {
+    std::vector<int> cpus = online_cpus();
+    if (config.threads > 0 && static_cast<size_t>(config.threads) < cpus.size()) cpus.resize(config.threads);
+    return cpus;
+}
+
+bool PCTester::Impl::pin_thread_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    // pid 0 applies the mask to the calling thread only
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// Width of one entry in the all-core throughput timeline
+static const double kCpuSliceSeconds = 0.1;
+
+// Length of one repetition of the single-thread and all-core scores
+static const double kCpuRunSeconds = 0.2;
+
+// Length of one repetition of a vector kernel
+static const double kSimdRunSeconds = 0.05;
+
+// Length of one repetition of an integer or crypto workload
+static const double kWorkloadRunSeconds = 0.1;
+
+// Length of one repetition of a rasterizer workload
+static const double kRasterRunSeconds = 0.25;
+
+// Runs one pinned worker per entry in cpus for the given wall time and
+// returns each worker's throughput in millions of series terms per second.
+// With slices, also fills the combined throughput of every complete
+// kCpuSliceSeconds window, in the same unit.
+std::vector<double> PCTester::Impl::run_cpu_workers(const std::vector<int>& cpus, double seconds, std::vector<double>* slices) {
+    std::vector<double> scores(cpus.size(), 0.0);
+    size_t slice_count = slices ? static_cast<size_t>(seconds / kCpuSliceSeconds) : 0;
+    std::vector<std::vector<uint64_t>> terms(cpus.size(), std::vector<uint64_t>(slice_count + 1, 0));
+    std::vector<std::thread> workers;
+    std::atomic<size_t> ready(0);
+    std::atomic<bool> go(false);
+    std::atomic<double> sink(0.0);
     
-    // Run tests
-    cpu_benchmark();
-    gpu_benchmark();
+    for (size_t w = 0; w < cpus.size(); w++) {
+        workers.emplace_back([&, w]() {
+            if (!pin_thread_to_cpu(cpus[w])) {
+                SafeOutput::error("[CPU] Failed to pin worker to CPU " + std::to_string(cpus[w]));
+            }
+            ready++;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            
+            auto start = std::chrono::steady_clock::now();
+            auto deadline = start + std::chrono::duration<double>(seconds);
+            uint64_t next = 1;
+            double sum = 0.0;
+            auto now = start;
+            do {
+                sum += basel_chunk(next, kCpuChunkTerms);
+                next += kCpuChunkTerms;
+                now = std::chrono::steady_clock::now();
+                if (slice_count > 0) {
+                    size_t slice = static_cast<size_t>(std::chrono::duration<double>(now - start).count() / kCpuSliceSeconds);
+                    terms[w][std::min(slice, slice_count)] += kCpuChunkTerms;
+                }
+            } while (now < deadline);
+            
+            std::chrono::duration<double> elapsed = now - start;
+            scores[w] = (next - 1) / elapsed.count() / 1e6;
+            
+            // Keep the result observable so the loop cannot be elided
+            double expected = sink.load();
+            while (!sink.compare_exchange_weak(expected, expected + sum)) {}
+        });
+    }
     
-    // Stop monitoring
-    stop_monitoring = true;
-    temp_monitor.join();
+    while (ready < cpus.size()) std::this_thread::yield();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) worker.join();
     
-    SafeOutput::print("\nAll tests completed!");
+    if (slices) {
+        slices->assign(slice_count, 0.0);
+        for (size_t i = 0; i < slice_count; i++) {
+            for (const auto& worker_terms : terms) (*slices)[i] += worker_terms[i] / kCpuSliceSeconds / 1e6;
+        }
+    }
+    return scores;
 }
 
 void PCTester::Impl::cpu_benchmark() {
     SafeOutput::print("\n[CPU] Starting Linux-optimized stress test...");
     
+    std::vector<int> cpus = worker_cpus();
+    
     // Get CPU frequency
     double base_freq = 0.0;
-    for (int i = 0; i < sys_info.cpu_cores; i++) {
-        std::string freq_file = "/sys/devices/system/cpu/cpu" + std::to_string(i) + "/cpufreq/cpuinfo_max_freq";
+    for (int cpu : cpus) {
+        std::string freq_file = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq";
         std::ifstream freq(freq_file);
         if (freq.is_open()) {
             double freq_val;
@@ -119,99 +277,222 @@ void PCTester::Impl::cpu_benchmark() {
             if (freq_val > base_freq) base_freq = freq_val;
         }
     }
+    if (base_freq > 0.0) {
+        SafeOutput::print("[CPU] Max frequency: " + std::to_string(static_cast<int>(base_freq)) + " MHz");
+    }
+    SafeOutput::print("[CPU] Logical CPUs: " + std::to_string(cpus.size()));
     
-    if (base_freq == 0.0) base_freq = 2000.0; // Default to 2GHz
+    // Single-thread and all-core scores are medians of repeated short runs
+    BenchmarkOptions options = BenchmarkOptions::from(config);
+    test_results.cpu_single_score = record_stats("CPU", run_benchmark("Single-thread", "Mterms/s", options, [&]() {
+        return run_cpu_workers({cpus.front()}, kCpuRunSeconds).front();
+    })).median;
+    test_results.cpu_multi_score = record_stats("CPU", run_benchmark("All-core", "Mterms/s", options, [&]() {
+        double total = 0.0;
+        for (double score : run_cpu_workers(cpus, kCpuRunSeconds)) total += score;
+        return total;
+    })).median;
     
-    // Run complex mathematical operations
-    const int num_iterations = 100000000;
-    double sum = 0.0;
-    auto start = std::chrono::high_resolution_clock::now();
+    // One sustained all-core run: a score that sags partway through is
+    // throttling even when no sensor reports it
+    std::vector<double> slices;
+    run_cpu_workers(cpus, 2.0, &slices);
+    test_results.cpu_score_timeline.clear();
+    for (size_t i = 0; i < slices.size(); i++) {
+        test_results.cpu_score_timeline.emplace_back((i + 1) * kCpuSliceSeconds, slices[i]);
+    }
+    ThrottleEvent drop;
+    drop.phase = "CPU all-core";
+    if (TelemetrySampler::detect_score_drop(slices, kCpuSliceSeconds, drop)) {
+        test_results.throttle_events.push_back(drop);
+    }
     
-    for (int i = 1; i <= num_iterations; i++) {
-        sum += 1.0 / (i * i);
+    test_results.cpu_scaling_efficiency = 0.0;
+    if (test_results.cpu_single_score > 0.0) {
+        test_results.cpu_scaling_efficiency = 100.0 * test_results.cpu_multi_score /
+            (test_results.cpu_single_score * cpus.size());
     }
-    double pi = std::sqrt(6 * sum);
     
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
+    // Per-core sweep: each CPU alone, so a slow or throttled core stands out
+    test_results.cpu_core_scores.clear();
+    for (int cpu : cpus) {
+        test_results.cpu_core_scores.emplace_back(cpu, run_cpu_workers({cpu}, 0.25).front());
+    }
     
-    // Calculate score
-    double base_perf = base_freq * sys_info.cpu_cores;
-    double actual_perf = num_iterations / elapsed.count();
-    test_results.cpu_score = (actual_perf / base_perf) * 10000;
+    // Integer, branch-heavy and crypto kernels on this worker; with the FP
+    // series they make up the per-core composite
+    test_results.cpu_workload_scores.clear();
+    test_results.cpu_workload_scores.push_back(
+        score_cpu_workload(fp_series_workload(), "portable", test_results.cpu_single_score));
+    const std::vector<CpuWorkloadInfo>& workloads = cpu_workloads();
+    for (size_t i = 0; i < workloads.size(); i++) {
+        CpuWorkload workload = static_cast<CpuWorkload>(i);
+        double rate = record_stats("CPU", run_benchmark(workloads[i].name, workloads[i].unit, options, [&]() {
+            return run_cpu_workload(workload, kWorkloadRunSeconds);
+        })).median;
+        test_results.cpu_workload_scores.push_back(score_cpu_workload(workloads[i], cpu_workload_engine(workload), rate));
+    }
+    test_results.cpu_core_composite = cpu_composite_score(test_results.cpu_workload_scores);
+    
+    // All-core scaling of the FP series turns the per-core composite into
+    // a whole-CPU score
+    test_results.cpu_score = test_results.cpu_core_composite;
+    if (test_results.cpu_single_score > 0.0) {
+        test_results.cpu_score *= test_results.cpu_multi_score / test_results.cpu_single_score;
+    }
     test_results.cpu_temp = get_cpu_temperature();
     
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "[CPU] Single-thread: " << test_results.cpu_single_score << " | All-core: "
+       << test_results.cpu_multi_score << " | Scaling: " << test_results.cpu_scaling_efficiency << "%";
+    SafeOutput::print(ss.str());
+    
+    if (!test_results.cpu_core_scores.empty()) {
+        double best = 0.0;
+        for (const auto& core : test_results.cpu_core_scores) best = std::max(best, core.second);
+        for (const auto& core : test_results.cpu_core_scores) {
+            std::stringstream line;
+            line << std::fixed << std::setprecision(1);
+            line << "[CPU]   cpu" << core.first << ": " << core.second;
+            if (core.second < 0.9 * best) line << "  (slow: " << 100.0 * core.second / best << "% of best)";
+            SafeOutput::print(line.str());
+        }
+    }
+    
+    for (const auto& workload : test_results.cpu_workload_scores) {
+        std::stringstream line;
+        line << std::fixed << std::setprecision(0);
+        line << "[CPU]   " << std::left << std::setw(18) << workload.name << " " << std::right << std::setw(6)
+             << workload.score << "  (" << workload.engine << (workload.weight > 0.0 ? ")" : ", not in composite)");
+        SafeOutput::print(line.str());
+    }
+    
+    SafeOutput::print("[CPU] Per-core composite: " + std::to_string(test_results.cpu_core_composite));
     SafeOutput::print("[CPU] Score: " + std::to_string(test_results.cpu_score));
     SafeOutput::print("[CPU] Temperature: " + std::to_string(test_results.cpu_temp) + "°C");
 }
 
-void PCTester::Impl::gpu_benchmark() {
-    SafeOutput::print("\n[GPU] Starting OpenCL benchmark simulation...");
+void PCTester::Impl::simd_benchmark() {
+    SafeOutput::print("\n[SIMD] Starting vector kernel suite...");
     
-    auto start = std::chrono::high_resolution_clock::now();
+    BenchmarkOptions options = BenchmarkOptions::from(config);
+    auto measure = [&](SimdIsa isa, SimdKernel kernel, const char* name, const char* unit) {
+        BenchmarkStats stats = run_benchmark(std::string(simd_isa_name(isa)) + " " + name, unit, options, [&]() {
+            return run_simd_kernel(isa, kernel, kSimdRunSeconds);
+        });
+        test_results.bench_stats.push_back(stats);
+        return stats.median;
+    };
     
-    // Simulate GPU work
-    double sum = 0.0;
-    for (long i = 1; i < 10000000; i++) {
-        sum += 1.0 / (i * i);
+    test_results.simd_scores.clear();
+    for (SimdIsa isa : detect_simd_isas()) {
+        SimdScore score{};
+        score.isa = simd_isa_name(isa);
+        score.fma_gflops = measure(isa, SimdKernel::Fma, "FMA", "GFLOPS");
+        score.dot_gflops = measure(isa, SimdKernel::Dot, "Dot", "GFLOPS");
+        score.saxpy_gbs = measure(isa, SimdKernel::Saxpy, "SAXPY", "GB/s");
+        score.hash_gops = measure(isa, SimdKernel::Hash, "Hash", "G/s");
+        test_results.simd_scores.push_back(score);
+        
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2);
+        ss << "[SIMD] " << std::left << std::setw(8) << score.isa
+           << " FMA: " << score.fma_gflops << " GFLOPS | Dot: " << score.dot_gflops
+           << " GFLOPS | SAXPY: " << score.saxpy_gbs << " GB/s | Hash: " << score.hash_gops << " G/s";
+        SafeOutput::print(ss.str());
     }
+}
+
+void PCTester::Impl::gpu_benchmark() {
+    SafeOutput::print("\n[GPU] Starting software rasterizer...");
     
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
+    // Most hosts are headless, so graphics work is measured where it will
+    // actually run: tile-parallel rasterization on the scheduler workers
+    test_results.gpu_engine = std::string("software, ") + simd_isa_name(raster_isa()) + ", " +
+                              std::to_string(scheduler.worker_count()) + " workers";
+    SafeOutput::print("[GPU] Engine: " + test_results.gpu_engine);
+    if (!sys_info.gpu_name.empty()) SafeOutput::print("[GPU] Display adapter (not used): " + sys_info.gpu_name);
     
-    // Calculate GPU score
-    test_results.gpu_score = 10000000 / elapsed.count();
+    BenchmarkOptions options = BenchmarkOptions::from(config);
+    auto measure = [&](RasterWorkload workload, const char* name, const char* unit) {
+        return record_stats("GPU", run_benchmark(name, unit, options, [&]() {
+            return run_raster_workload(scheduler, workload, kRasterRunSeconds);
+        })).median;
+    };
+    test_results.gpu_triangle_rate = measure(RasterWorkload::Geometry, "Triangles", "Mtri/s");
+    test_results.gpu_fill_rate = measure(RasterWorkload::Fill, "Fill rate", "Gpix/s");
+    test_results.gpu_compute_rate = measure(RasterWorkload::Shade, "Compute shading", "Gpix/s");
+    test_results.gpu_score = test_results.gpu_triangle_rate;
     
-    SafeOutput::print("[GPU] Benchmark completed: " + sys_info.gpu_name);
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "[GPU] Triangles: " << test_results.gpu_triangle_rate << " Mtri/s | Fill: " << test_results.gpu_fill_rate
+       << " Gpix/s | Compute: " << test_results.gpu_compute_rate << " Gpix/s";
+    SafeOutput::print(ss.str());
     SafeOutput::print("[GPU] Score: " + std::to_string(test_results.gpu_score));
 }
 
-double PCTester::Impl::get_cpu_temperature() {
-    double max_temp = 0.0;
-    DIR* dir = opendir("/sys/class/thermal");
-    if (dir) {
-        struct dirent* entry;
-        while ((entry = readdir(dir)) != NULL) {
-            if (strstr(entry->d_name, "thermal_zone")) {
-                std::string temp_path = "/sys/class/thermal/" + std::string(entry->d_name) + "/temp";
-                std::ifstream temp_file(temp_path);
-                if (temp_file.is_open()) {
-                    double temp;
-                    temp_file >> temp;
-                    temp /= 1000.0; // Convert millidegrees to Celsius
-                    if (temp > max_temp) max_temp = temp;
-                }
-            }
-        }
-        closedir(dir);
-    }
-    return max_temp;
+// Keeps a repeated measurement for the report and prints it under tag
+const BenchmarkStats& PCTester::Impl::record_stats(const char* tag, const BenchmarkStats& stats) {
+    test_results.bench_stats.push_back(stats);
+    SafeOutput::print(std::string("[") + tag + "] " + stats.name + ": " + format_stats(stats));
+    return test_results.bench_stats.back();
 }
 
-double PCTester::Impl::get_gpu_temperature() {
-    // Simulated GPU temperature
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dist(50.0, 85.0);
-    return dist(gen);
+void PCTester::Impl::report_counters(const std::string& stage) const {
+    const PerfCounters& counters = test_results.perf_counters.at(stage);
+    if (!counters.available) {
+        SafeOutput::print("[PERF] " + stage + ": hardware counters unavailable");
+        return;
+    }
+    // Misses per thousand instructions, or n/a for events the CPU lacks
+    auto mpki = [&counters](double misses) {
+        if (misses < 0.0 || counters.instructions <= 0.0) return std::string("n/a");
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2) << 1000.0 * misses / counters.instructions;
+        return ss.str();
+    };
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "[PERF] " << stage << ": IPC " << counters.ipc << " | LLC MPKI " << mpki(counters.llc_misses)
+       << " | Branch MPKI " << mpki(counters.branch_misses) << " | dTLB MPKI " << mpki(counters.dtlb_misses);
+    if (counters.per_cpu) ss << " (everything on the stage's CPUs)";
+    if (counters.partial) {
+        ss << " (partial: scheduler workers not counted"
+           << (counters.overlapped ? ", per-CPU counts would include the storage lane)" : ")");
+    }
+    SafeOutput::print(ss.str());
 }
 
-void PCTester::Impl::monitor_temperatures(std::atomic<bool>& stop_monitoring) {
-    SafeOutput::print("[MONITOR] Starting temperature monitoring...");
+void PCTester::Impl::report_throttling() {
+    test_results.nominal_freq_mhz = telemetry.nominal_freq_mhz();
+    test_results.thermal_limit_c = telemetry.thermal_limit_c();
+    for (const ThrottleEvent& event : telemetry.detect_throttling(test_results.telemetry_phases)) {
+        test_results.throttle_events.push_back(event);
+    }
     
-    while (!stop_monitoring) {
-        double cpu_temp = get_cpu_temperature();
-        double gpu_temp = get_gpu_temperature();
-        
+    if (!telemetry.has_frequency() && !telemetry.has_temperature()) {
+        SafeOutput::print("[THROTTLE] No frequency or temperature sensors; checking score drops only");
+    }
+    if (test_results.throttle_events.empty()) {
+        SafeOutput::print("[THROTTLE] No sustained throttling detected");
+    }
+    for (const ThrottleEvent& event : test_results.throttle_events) {
         std::stringstream ss;
-        ss << "[TEMP] CPU: " << std::fixed << std::setprecision(1) << cpu_temp << "°C";
-        ss << " | GPU: " << gpu_temp << "°C";
+        ss << std::fixed << std::setprecision(1);
+        ss << "[THROTTLE] " << event.phase << ": " << event.cause << " throttling from +" << event.onset_s
+           << " s for " << event.duration_s << " s, " << event.perf_loss_pct << "% slower";
         SafeOutput::print(ss.str());
-        
-        std::this_thread::sleep_for(std::chrono::seconds(2));
     }
-    
-    SafeOutput::print("[MONITOR] Temperature monitoring stopped");
+}
+
+double PCTester::Impl::get_cpu_temperature() {
+    return telemetry.latest().cpu_temp_c;
+}
+
+double PCTester::Impl::get_gpu_temperature() {
+    return telemetry.latest().gpu_temp_c;
 }
 
 void PCTester::Impl::generate_html_report(const std::string& filename) const {
@@ -236,6 +517,8 @@ void PCTester::Impl::generate_html_report(const std::string& filename) const {
         .gauge-fill { height: 100%; background: #e95420; }
         .score { font-size: 1.8em; font-weight: bold; text-align: center; margin: 10px 0; }
         .summary { background: #fdf6f2; padding: 20px; border-radius: 8px; margin-top: 20px; }
+        table { border-collapse: collapse; background: white; }
+        th, td { padding: 6px 12px; border: 1px solid #e0e0e0; text-align: right; }
     </style>
 </head>
 <body>
@@ -254,42 +537,484 @@ void PCTester::Impl::generate_html_report(const std::string& filename) const {
             <div class="metric">
                 <div class="metric-title">Processor</div>
                 <div>)" << sys_info.cpu_name << R"(</div>
-                <div>Cores: )" << sys_info.cpu_cores << R"(, Threads: )" << sys_info.cpu_threads << R"(</div>
+                <div>Sockets: )" << sys_info.cpu_sockets << R"(, Cores: )" << sys_info.cpu_cores
+                 << R"(, Threads: )" << sys_info.cpu_threads << R"(</div>
             </div>
             <div class="metric">
                 <div class="metric-title">Graphics</div>
-                <div>)" << sys_info.gpu_name << R"(</div>
-                <div>)" << sys_info.gpu_memory << R"( MB VRAM</div>
+                <div>)" << (sys_info.gpu_name.empty() ? "None found" : sys_info.gpu_name) << R"(</div>
+                <div>)" << (sys_info.gpu_memory ? std::to_string(sys_info.gpu_memory) + " MB VRAM" : "VRAM unknown") << R"(</div>
             </div>
         </div>
     </div>
     
-    <div class="section">
+    )";
+    
+    if (!sys_info.dimms.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">Memory Modules</h2>
+        <table>
+            <tr><th>Slot</th><th>Size</th><th>Type</th><th>Speed</th><th>Manufacturer</th><th>Part Number</th></tr>)";
+        for (const auto& dimm : sys_info.dimms) {
+            file << R"(
+            <tr><td>)" << dimm.locator << "</td><td>" << (dimm.size >> 20) << " MB</td><td>" << dimm.type
+                 << "</td><td>" << (dimm.speed_mts ? std::to_string(dimm.speed_mts) + " MT/s" : "-") << "</td><td>"
+                 << dimm.manufacturer << "</td><td>" << dimm.part_number << "</td></tr>";
+        }
+        file << R"(
+        </table>
+    </div>
+    
+    )";
+    }
+    
+    file << R"(<div class="section">
         <h2 class="section-title">Performance Metrics</h2>
         <div class="grid">
             <div class="metric">
                 <div class="metric-title">CPU Performance</div>
                 <div class="score">)" << std::fixed << std::setprecision(1) << test_results.cpu_score << R"(</div>
                 <div>Temperature: )" << test_results.cpu_temp << R"(°C</div>
+                <div>Per-core composite: )" << test_results.cpu_core_composite << R"(</div>
+                <div>Single-thread: )" << test_results.cpu_single_score << R"(, Scaling: )" << test_results.cpu_scaling_efficiency << R"(%</div>
                 <div class="gauge"><div class="gauge-fill" style="width: )" 
                  << std::min(100.0, test_results.cpu_score / 200) << R"(%"></div></div>
             </div>
             <div class="metric">
-                <div class="metric-title">GPU Performance</div>
-                <div class="score">)" << std::fixed << std::setprecision(1) << test_results.gpu_score << R"(</div>
+                <div class="metric-title">Memory Bandwidth</div>
+                <div class="score">)" << test_results.ram_score << R"( GB/s</div>
+                <div>Memory in use: )" << test_results.ram_usage << R"(%</div>
+                <div class="gauge"><div class="gauge-fill" style="width: )" 
+                 << std::min(100.0, test_results.ram_score) << R"(%"></div></div>
+            </div>
+            <div class="metric">
+                <div class="metric-title">Disk Throughput</div>
+                <div class="score">)" << test_results.disk_read << R"( MB/s</div>
+                <div>Read: )" << test_results.disk_read << R"( MB/s, Write: )" << test_results.disk_write << R"( MB/s</div>
+                <div class="gauge"><div class="gauge-fill" style="width: )" 
+                 << std::min(100.0, test_results.disk_read / 50) << R"(%"></div></div>
+            </div>
+            <div class="metric">
+                <div class="metric-title">GPU Performance ()" << test_results.gpu_engine << R"()</div>
+                <div class="score">)" << std::fixed << std::setprecision(1) << test_results.gpu_score << R"( Mtri/s</div>
+                <div>Fill: )" << std::setprecision(2) << test_results.gpu_fill_rate << R"( Gpix/s, Compute: )"
+                 << test_results.gpu_compute_rate << R"( Gpix/s</div>
+                <div class="gauge"><div class="gauge-fill" style="width: )" 
+                 << std::setprecision(1) << std::min(100.0, test_results.gpu_score / 10) << R"(%"></div></div>
+            </div>
+        </div>
+    </div>
+    
+    <div class="section">
+        <h2 class="section-title">CPU Workloads</h2>
+        <table>
+            <tr><th>Workload</th><th>Engine</th><th>Rate</th><th>Score</th><th>Weight</th></tr>)";
+    
+    for (const auto& workload : test_results.cpu_workload_scores) {
+        file << R"(
+            <tr><td>)" << workload.name << "</td><td>" << workload.engine << "</td><td>" << std::setprecision(2)
+             << workload.rate << " " << workload.unit << "</td><td>" << std::setprecision(0) << workload.score
+             << "</td><td>";
+        if (workload.weight > 0.0) {
+            file << 100.0 * workload.weight << "%</td></tr>";
+        } else {
+            file << "not in composite</td></tr>";
+        }
+    }
+    
+    file << std::setprecision(1) << R"(
+        </table>
+        <div>Kernels whose reference was measured with CRC32, AES or SHA instructions count in the composite only when this CPU ran them the same way.</div>
+    </div>
+    
+    <div class="section">
+        <h2 class="section-title">Per-Core Scores</h2>
+        <div class="grid">)";
+    
+    double best_core = 0.0;
+    for (const auto& core : test_results.cpu_core_scores) best_core = std::max(best_core, core.second);
+    for (const auto& core : test_results.cpu_core_scores) {
+        file << R"(
+            <div class="metric">
+                <div class="metric-title">CPU )" << core.first << R"(</div>
+                <div>)" << core.second << R"(</div>
                 <div class="gauge"><div class="gauge-fill" style="width: )" 
-                 << std::min(100.0, test_results.gpu_score / 1000) << R"(%"></div></div>
+                 << (best_core > 0.0 ? 100.0 * core.second / best_core : 0.0) << R"(%"></div></div>
+            </div>)";
+    }
+    
+    file << R"(
+        </div>
+    </div>
+    
+    <div class="section">
+        <h2 class="section-title">Memory Bandwidth (STREAM)</h2>
+        <div class="grid">)";
+    
+    for (const auto& stream : test_results.stream_results) {
+        file << R"(
+            <div class="metric">
+                <div class="metric-title">)" << stream.threads << R"( threads</div>
+                <div>Copy: )" << stream.copy_gbs << R"( GB/s</div>
+                <div>Scale: )" << stream.scale_gbs << R"( GB/s</div>
+                <div>Add: )" << stream.add_gbs << R"( GB/s</div>
+                <div>Triad: )" << stream.triad_gbs << R"( GB/s</div>
+            </div>)";
+    }
+    
+    file << R"(
+        </div>
+    </div>
+    
+    <div class="section">
+        <h2 class="section-title">Memory Latency</h2>
+        <div class="grid">
+            <div class="metric">
+                <div class="metric-title">Load-to-use latency</div>)";
+    
+    for (const auto& point : test_results.latency_curve) {
+        file << R"(
+                <div>)" << (point.first >> 10) << R"( KiB: )" << point.second << R"( ns</div>)";
+    }
+    
+    file << R"(
+            </div>
+            <div class="metric">
+                <div class="metric-title">Cache hierarchy</div>)";
+    
+    for (const auto& cache : sys_info.caches) {
+        file << R"(
+                <div>L)" << cache.level << " " << cache.type << ": " << (cache.size >> 10) << R"( KiB (sysfs)</div>)";
+    }
+    for (size_t i = 0; i < test_results.detected_cache_sizes.size(); i++) {
+        file << R"(
+                <div>Level )" << i + 1 << R"( boundary: )" << (test_results.detected_cache_sizes[i] >> 10) << R"( KiB (measured)</div>)";
+    }
+    
+    file << R"(
+                <div>DRAM: )" << test_results.ram_latency_ns << R"( ns</div>
             </div>
         </div>
     </div>
     
+    )";
+    
+    if (!test_results.numa_bandwidth_gbs.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">NUMA Bandwidth / Latency (CPU node x memory node)</h2>
+        <table>
+            <tr><th>CPU \ Memory</th>)";
+        for (const auto& node : sys_info.numa_nodes) file << "<th>node" << node.id << "</th>";
+        file << "</tr>";
+        for (size_t a = 0; a < sys_info.numa_nodes.size(); a++) {
+            file << R"(
+            <tr><th>node)" << sys_info.numa_nodes[a].id << "</th>";
+            for (size_t b = 0; b < sys_info.numa_nodes.size(); b++) {
+                double latency = test_results.numa_latency_ns[a][b];
+                file << "<td>" << test_results.numa_bandwidth_gbs[a][b] << " GB/s<br>";
+                if (std::isnan(latency)) {
+                    file << "latency failed</td>";
+                } else {
+                    file << latency << " ns</td>";
+                }
+            }
+            file << "</tr>";
+        }
+        file << R"(
+        </table>
+    </div>
+    
+    )";
+    }
+    
+    if (!test_results.disk_profiles.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">Storage I/O ()" << test_results.disk_engine << R"()</h2>
+        <table>
+            <tr><th>Profile</th><th>Block</th><th>QD</th><th>MB/s</th><th>IOPS</th><th>p50 (us)</th><th>p99 (us)</th><th>p99.9 (us)</th></tr>)";
+        for (const auto& disk : test_results.disk_profiles) {
+            file << R"(
+            <tr><td>)" << disk.name << "</td><td>" << (disk.block_size >> 10) << " KiB</td><td>" << disk.queue_depth
+                 << "</td><td>" << disk.mbps << "</td><td>" << disk.iops << "</td><td>" << disk.p50_us
+                 << "</td><td>" << disk.p99_us << "</td><td>" << disk.p999_us << "</td></tr>";
+        }
+        file << R"(
+        </table>
+    </div>
+    
+    )";
+    }
+    
+    if (!test_results.disk_sync_results.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">Flush Latency (small append + sync)</h2>
+        <div class="grid">)";
+        for (const auto& sync : test_results.disk_sync_results) {
+            uint64_t peak = 1;
+            for (const auto& bucket : sync.buckets) peak = std::max(peak, bucket.second);
+            file << R"(
+            <div class="metric">
+                <div class="metric-title">)" << sync.mode << " (" << sync.write_size << R"( bytes)</div>
+                <div>)" << sync.count << R"( operations, mean )" << sync.mean_us << R"( us</div>
+                <div>p50 )" << sync.p50_us << " / p90 " << sync.p90_us << " / p99 " << sync.p99_us
+                 << " / p99.9 " << sync.p999_us << " / max " << sync.max_us << R"( us</div>)";
+            for (const auto& bucket : sync.buckets) {
+                file << R"(
+                <div>&le; )" << bucket.first << " us: " << bucket.second << R"(</div>
+                <div class="gauge"><div class="gauge-fill" style="width: )"
+                     << 100.0 * bucket.second / peak << R"(%"></div></div>)";
+            }
+            file << R"(
+            </div>)";
+        }
+        file << R"(
+        </div>
+    </div>
+    
+    )";
+    }
+    
+    if (!test_results.mmap_results.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">Memory-Mapped File Access</h2>
+        <table>
+            <tr><th>Pattern</th><th>Access</th><th>Hint</th><th>MB/s</th><th>mmap() ms</th><th>Minor faults</th><th>Major faults</th><th>Huge pages (KiB)</th></tr>)";
+        for (const auto& mapped : test_results.mmap_results) {
+            file << R"(
+            <tr><td>)" << mapped.pattern << "</td><td>" << (mapped.write ? "write" : "read") << "</td><td>" << mapped.hint
+                 << "</td><td>" << mapped.mbps << "</td><td>" << mapped.map_seconds * 1000.0 << "</td><td>" << mapped.minor_faults
+                 << "</td><td>" << mapped.major_faults << "</td><td>";
+            if (std::isnan(mapped.huge_page_kb)) file << "-";
+            else file << mapped.huge_page_kb;
+            file << "</td></tr>";
+        }
+        file << R"(
+        </table>
+    </div>
+    
+    )";
+    }
+    
+    if (!test_results.network_target.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">Network ()" << test_results.network_target << R"()</h2>
+        <div class="grid">
+            <div class="metric">
+                <div class="metric-title">TCP Stream</div>
+                <div class="score">)" << test_results.network_bandwidth << R"( Mbit/s</div>
+                <div>)" << test_results.network_streams << R"( connections</div>
+            </div>
+            <div class="metric">
+                <div class="metric-title">TCP Round Trip</div>
+                <div class="score">)" << test_results.network_latency << R"( us</div>
+                <div>p99 )" << test_results.network_rtt_p99_us << " us / p99.9 " << test_results.network_rtt_p999_us << R"( us</div>
+            </div>
+            <div class="metric">
+                <div class="metric-title">UDP Echo</div>
+                <div class="score">)" << test_results.network_udp_pps / 1000.0 << R"( kpps</div>
+                <div>Loss: )" << test_results.network_udp_loss << R"(%</div>
+            </div>
+        </div>
+    </div>
+    
+    )";
+    }
+    
+    if (!test_results.network_stress_loops.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">Connection Stress (epoll, )" << test_results.network_stress_connections << R"( connections)</h2>
+        <div class="grid">
+            <div class="metric">
+                <div class="metric-title">Requests</div>
+                <div class="score">)" << test_results.network_stress_rps / 1000.0 << R"( k/s</div>
+                <div>Loop balance: )" << test_results.network_stress_balance << R"(</div>
+            </div>
+            <div class="metric">
+                <div class="metric-title">Request Latency</div>
+                <div class="score">)" << test_results.network_stress_p50_us << R"( us</div>
+                <div>p99 )" << test_results.network_stress_p99_us << " us / p99.9 " << test_results.network_stress_p999_us << R"( us</div>
+            </div>
+        </div>
+        <table>
+            <tr><th>CPU</th><th>Connections</th><th>k requests/s</th></tr>)";
+        for (const auto& loop : test_results.network_stress_loops) {
+            file << R"(
+            <tr><td>)" << loop.cpu << "</td><td>" << loop.connections << "</td><td>" << loop.requests_per_sec / 1000.0 << "</td></tr>";
+        }
+        file << R"(
+        </table>
+    </div>
+    
+    )";
+    }
+    
+    if (!test_results.telemetry_phases.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">Telemetry ()" << test_results.telemetry_period_ms << R"( ms samples)</h2>
+        <table>
+            <tr><th>Stage</th><th>Seconds</th><th>Samples</th><th>Peak CPU &deg;C</th><th>Avg MHz</th><th>Min MHz</th><th>Avg Busy %</th><th>Avg Package W</th></tr>)";
+        for (const auto& phase : test_results.telemetry_phases) {
+            double peak_temp = 0.0, freq_sum = 0.0, min_freq = 0.0, util_sum = 0.0, power_sum = 0.0;
+            for (const auto& sample : phase.samples) {
+                peak_temp = std::max(peak_temp, sample.cpu_temp_c);
+                freq_sum += sample.freq_avg_mhz;
+                if (sample.freq_min_mhz > 0.0 && (min_freq == 0.0 || sample.freq_min_mhz < min_freq)) min_freq = sample.freq_min_mhz;
+                util_sum += sample.cpu_util_pct;
+                power_sum += sample.package_power_w;
+            }
+            double count = static_cast<double>(std::max<size_t>(phase.samples.size(), 1));
+            file << R"(
+            <tr><td>)" << phase.name << "</td><td>" << phase.end_s - phase.start_s << "</td><td>" << phase.samples.size()
+                 << "</td><td>" << peak_temp << "</td><td>" << freq_sum / count << "</td><td>" << min_freq
+                 << "</td><td>" << util_sum / count << "</td><td>" << power_sum / count << "</td></tr>";
+        }
+        file << R"(
+        </table>
+    </div>
+
+    )";
+    }
+    
+    if (!test_results.bench_stats.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">Measurement Statistics</h2>
+        <table>
+            <tr><th>Measurement</th><th>Median</th><th>Unit</th><th>RSE %</th><th>95% CI</th><th>Min</th><th>Std Dev</th><th>Runs</th><th>Outliers</th><th>Converged</th></tr>)";
+        for (const auto& stats : test_results.bench_stats) {
+            file << R"(
+            <tr><td>)" << stats.name << "</td><td>" << stats.median << "</td><td>" << stats.unit << "</td><td>" << stats.rse_pct
+                 << "</td><td>" << stats.ci95_low << " - " << stats.ci95_high << "</td><td>" << stats.min << "</td><td>" << stats.stddev
+                 << "</td><td>" << stats.runs << "</td><td>" << stats.outliers << "</td><td>" << (stats.converged ? "yes" : "no") << "</td></tr>";
+        }
+        file << R"(
+        </table>
+    </div>
+    
+    )";
+    }
+    
+    bool any_counters = false;
+    for (const auto& entry : test_results.perf_counters) any_counters = any_counters || entry.second.available;
+    if (any_counters) {
+        auto per_kilo = [](double misses, double instructions) {
+            return misses < 0.0 || instructions <= 0.0 ? std::string("n/a") : std::to_string(1000.0 * misses / instructions);
+        };
+        file << R"(<div class="section">
+        <h2 class="section-title">Hardware Counters (user space)</h2>
+        <table>
+            <tr><th>Stage</th><th>Scope</th><th>G Cycles</th><th>G Instructions</th><th>IPC</th><th>LLC MPKI</th><th>Branch MPKI</th><th>dTLB MPKI</th></tr>)";
+        for (const auto& entry : test_results.perf_counters) {
+            const PerfCounters& counters = entry.second;
+            if (!counters.available) continue;
+            file << R"(
+            <tr><td>)" << entry.first << "</td><td>"
+                 << (counters.per_cpu ? "all tasks on its CPUs"
+                     : counters.overlapped ? "stage thread only (partial, lanes overlapped)"
+                     : counters.partial ? "stage thread only (partial)" : "stage threads")
+                 << "</td><td>" << counters.cycles / 1e9 << "</td><td>" << counters.instructions / 1e9
+                 << "</td><td>" << counters.ipc << "</td><td>" << per_kilo(counters.llc_misses, counters.instructions)
+                 << "</td><td>" << per_kilo(counters.branch_misses, counters.instructions)
+                 << "</td><td>" << per_kilo(counters.dtlb_misses, counters.instructions) << "</td></tr>";
+        }
+        file << R"(
+        </table>
+    </div>
+    
+    )";
+    }
+    
+    if (!test_results.throttle_events.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">Throttling</h2>
+        <div>Nominal clock: )" << test_results.nominal_freq_mhz << " MHz | Thermal limit: " << test_results.thermal_limit_c << R"( &deg;C</div>
+        <table>
+            <tr><th>Stage</th><th>Cause</th><th>Onset (s)</th><th>Duration (s)</th><th>Performance Lost %</th></tr>)";
+        for (const auto& event : test_results.throttle_events) {
+            file << R"(
+            <tr><td>)" << event.phase << "</td><td>" << event.cause << "</td><td>" << event.onset_s << "</td><td>"
+                 << event.duration_s << "</td><td>" << event.perf_loss_pct << "</td></tr>";
+        }
+        file << R"(
+        </table>
+    </div>
+    
+    )";
+    }
+    
+    if (!test_results.baseline_source.empty()) {
+        file << R"(<div class="section">
+        <h2 class="section-title">Baseline Comparison</h2>
+        <div>Baseline: )" << test_results.baseline_source << " (" << test_results.baseline_cpu << ") | Threshold: "
+             << config.regression_threshold_pct << R"(%</div>
+        <table>
+            <tr><th>Measurement</th><th>Baseline</th><th>Current</th><th>Unit</th><th>Change %</th><th>95% CI %</th><th>Verdict</th></tr>)";
+        for (const auto& delta : test_results.baseline_deltas) {
+            file << R"(
+            <tr><td>)" << delta.name << "</td><td>" << delta.baseline << "</td><td>" << delta.current << "</td><td>" << delta.unit
+                 << "</td><td>" << delta.delta_pct << "</td><td>";
+            if (std::isnan(delta.ci95_low_pct)) {
+                file << "-";
+            } else {
+                file << delta.ci95_low_pct << " - " << delta.ci95_high_pct;
+            }
+            file << "</td><td>" << delta.verdict << "</td></tr>";
+        }
+        file << R"(
+        </table>
+        <div>Rows without a CI are measured once per run (disk profiles, network, mmap, latency curve, NUMA) and are judged on the threshold alone.</div>
+    </div>
+    
+    )";
+    }
+    
+    file << R"(<div class="section">
+        <h2 class="section-title">Vector Kernels</h2>
+        <div class="grid">)";
+    
+    for (const auto& simd : test_results.simd_scores) {
+        file << R"(
+            <div class="metric">
+                <div class="metric-title">)" << simd.isa << R"(</div>
+                <div>FMA: )" << simd.fma_gflops << R"( GFLOPS</div>
+                <div>Dot product: )" << simd.dot_gflops << R"( GFLOPS</div>
+                <div>SAXPY: )" << simd.saxpy_gbs << R"( GB/s</div>
+                <div>Integer hash: )" << simd.hash_gops << R"( G/s</div>
+            </div>)";
+    }
+    
+    // Only claim healthy temperatures when something was actually checked
+    std::string throttle_summary;
+    if (!test_results.throttle_events.empty()) {
+        double worst = 0.0;
+        for (const auto& event : test_results.throttle_events) worst = std::max(worst, event.perf_loss_pct);
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << "Throttling detected in " << test_results.throttle_events.size()
+           << " stage measurement(s), up to " << worst << "% performance lost";
+        throttle_summary = ss.str();
+    } else if (test_results.nominal_freq_mhz > 0.0 || test_results.thermal_limit_c > 0.0) {
+        throttle_summary = "No throttling: clocks and temperatures stayed within limits under load";
+    } else {
+        throttle_summary = "No throttling seen in CPU scores (no frequency or temperature sensors available)";
+    }
+    std::string baseline_summary;
+    if (!test_results.baseline_source.empty()) {
+        baseline_summary = "<li>" + std::to_string(test_results.baseline_regressions) + " significant regression(s) against the baseline</li>";
+    }
+    
+    file << R"(
+        </div>
+    </div>
+    
     <div class="summary">
         <h2>Diagnostic Summary</h2>
         <p>Your Linux system performance analysis:</p>
         <ul>
             <li>CPU performance is )" << (test_results.cpu_score > 5000 ? "excellent" : "adequate") << R"(</li>
-            <li>GPU performance is )" << (test_results.gpu_score > 500 ? "excellent" : "adequate") << R"(</li>
-            <li>System is running within safe temperature ranges</li>
+            <li>Memory bandwidth is )" << (test_results.ram_score > 20 ? "excellent" : "adequate") << R"(</li>
+            <li>Disk performance is )" << (test_results.disk_read > 1000 ? "excellent" : "adequate") << R"(</li>
+            <li>GPU performance is )" << (test_results.gpu_score > 100 ? "excellent" : "adequate") << R"(</li>
+            <li>)" << throttle_summary << R"(</li>
+            )" << baseline_summary << R"(
         </ul>
     </div>
 </body>
@@ -297,3 +1022,52 @@ void PCTester::Impl::generate_html_report(const std::string& filename) const {
     
     SafeOutput::print("Report generated: " + filename);
 }
+
+void PCTester::Impl::export_results(const std::string& filename, ResultFormat format) const {
+    if (!export_results_file(filename, format, sys_info, test_results)) {
+        throw std::runtime_error("Failed to write results file");
+    }
+    SafeOutput::print("Results exported: " + filename);
+}
+
+int PCTester::Impl::compare_to_baseline(const std::string& path) {
+    int regressions = apply_baseline(path, config.regression_threshold_pct, sys_info, test_results);
+    publish_metrics();
+    return regressions;
+}
+
+// Results are published whole at stage boundaries; telemetry is rendered
+// at scrape time, and only when the sampler has taken a new sample
+void PCTester::Impl::start_metrics() {
+    try {
+        metrics = std::make_unique<MetricsServer>(config.metrics_port);
+    } catch (const std::exception& e) {
+        SafeOutput::error("[METRICS] " + std::string(e.what()));
+        return;
+    }
+    metrics->add_live_section("telemetry", [this]() { return telemetry.samples_taken(); }, [this]() {
+        TelemetrySample sample;
+        if (!telemetry.last_sample(sample)) return std::string();
+        OpenMetricsWriter writer;
+        writer.begin("telemetry");
+        writer.field("cpu_temp_c", sample.cpu_temp_c);
+        writer.field("gpu_temp_c", sample.gpu_temp_c);
+        writer.field("cpu_util_pct", sample.cpu_util_pct);
+        writer.field("freq_avg_mhz", sample.freq_avg_mhz);
+        writer.field("freq_min_mhz", sample.freq_min_mhz);
+        writer.field("freq_max_mhz", sample.freq_max_mhz);
+        writer.field("package_power_w", sample.package_power_w);
+        writer.end();
+        return writer.text();
+    });
+    publish_metrics();
+    metrics->start();
+    SafeOutput::print("[METRICS] Serving http://127.0.0.1:" + std::to_string(metrics->port()) + "/metrics");
+}
+
+void PCTester::Impl::publish_metrics() {
+    if (!metrics) return;
+    OpenMetricsWriter writer;
+    write_results(writer, sys_info, test_results);
+    metrics->publish("results", writer.text());
+}
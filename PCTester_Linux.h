@@ -1,7 +1,11 @@
 #pragma once
 
 #include "PCTester.h"
+#include "PCTester_Scheduler.h"
+#include "PCTester_Linux_Telemetry.h"
+#include "PCTester_Linux_Metrics.h"
 #include <fstream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -13,26 +17,77 @@
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <sched.h>
 
 class PCTester::Impl {
 public:
-    Impl();
-    void run_full_diagnostics();
+    explicit Impl(const TestConfig& config);
+    void run_stages(const std::vector<std::string>& names);
+    static std::vector<std::string> stage_names();
     void generate_html_report(const std::string& filename) const;
+    void export_results(const std::string& filename, ResultFormat format) const;
+    int compare_to_baseline(const std::string& path);
+    void run_daemon();
+    static void network_server(uint16_t port);
     
 private:
+    TestConfig config;
     SystemInfo sys_info;
-    TestResults test_results;
+    TestResults test_results{};
+    TaskScheduler scheduler;
+    TelemetrySampler telemetry;
+    std::unique_ptr<MetricsServer> metrics;     // null unless config.metrics_port
+    
+    // Every stage in serial order; storage stages form their own lane when
+    // stages are pipelined
+    struct Stage {
+        const char* name;
+        void (Impl::*run)();
+        bool storage;
+        bool workers;   // runs its work as tasks on the scheduler's workers
+    };
+    static const std::vector<Stage>& stages();
     
     void collect_system_info();
     void cpu_benchmark();
+    void simd_benchmark();
     void ram_test();
+    void ram_latency_test();
+    void numa_test();
     void disk_test();
+    void disk_sync_test(const std::string& directory);
+    void mmap_test();
+    std::string scratch_directory() const;
     void network_test();
+    void network_stress_test();
     void gpu_benchmark();
-    void monitor_temperatures(std::atomic<bool>& stop_monitoring);
+    void start_metrics();
+    void publish_metrics();
+    void report_throttling();
+    void report_counters(const std::string& stage) const;
+    const BenchmarkStats& record_stats(const char* tag, const BenchmarkStats& stats);
     
     double get_cpu_temperature();
     double get_gpu_temperature();
     double get_cpu_usage();
+    
+    // CPU engine helpers
+    std::vector<int> online_cpus() const;
+    std::vector<int> worker_cpus() const;
+    static bool pin_thread_to_cpu(int cpu);
+    std::vector<double> run_cpu_workers(const std::vector<int>& cpus, double seconds, std::vector<double>* slices = nullptr);
+    
+    // Memory subsystem helpers
+    StreamResult run_stream(const std::vector<int>& cpus, size_t elements, int mem_node = -1);
+    double memory_usage_percent() const;
+    size_t dram_working_set() const;
+    double chase_latency_ns(uint64_t working_set, uint64_t loads, int mem_node = -1);
+    
+    // System inventory, read straight from procfs and sysfs
+    void collect_cpu_topology();
+    void collect_cache_info();
+    void collect_numa_info();
+    void collect_pci_devices();
+    void collect_dimms();
+    static std::vector<int> parse_cpu_list(const std::string& list);
 };
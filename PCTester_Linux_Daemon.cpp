@@ -0,0 +1,272 @@
+#include "PCTester_Linux.h"
+#include "PCTester_Linux_Daemon.h"
+#include "PCTester_Export.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <map>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+namespace {
+
+// Probe lengths: long enough to settle, short enough to stay invisible
+const double kProbeCpuSeconds = 0.1;
+const uint64_t kProbeLatencyLoads = 1ull << 20;
+
+// Memory probes stay under this per array even when 4x the last-level
+// cache is larger; part cache, part DRAM then, which still tracks change
+const size_t kProbeMaxBytes = 64ull << 20;
+
+// A busy host stretches the wait between rounds up to this many intervals
+const int kMaxBackoff = 16;
+
+// Waits are sliced so a stop signal is noticed promptly
+const double kWaitSliceSeconds = 0.2;
+
+volatile sig_atomic_t stop_requested = 0;
+
+void request_stop(int) {
+    stop_requested = 1;
+}
+
+std::string errno_message(const std::string& what) {
+    return what + ": " + strerror(errno);
+}
+
+double unix_time_s() {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Newest value of every probe on every CPU, plus the round counters
+std::string probe_metrics(const std::vector<ProbeSample>& samples, uint64_t rounds, uint64_t skipped, int backoff) {
+    std::map<std::pair<std::string, int>, const ProbeSample*> newest;
+    for (const ProbeSample& sample : samples) newest[{ sample.probe, sample.cpu }] = &sample;
+    OpenMetricsWriter writer;
+    writer.begin("daemon");
+    writer.field("rounds", static_cast<double>(rounds));
+    writer.field("skipped", static_cast<double>(skipped));
+    writer.field("backoff", backoff);
+    writer.end();
+    for (const auto& entry : newest) {
+        const ProbeSample& sample = *entry.second;
+        writer.begin("probe");
+        writer.id("probe", sample.probe);
+        writer.id("cpu", sample.cpu);
+        writer.id("unit", sample.unit);
+        writer.field("value", sample.value);
+        writer.field("host_util_pct", sample.host_util_pct);
+        writer.end();
+    }
+    return writer.text();
+}
+
+} // namespace
+
+ProbeWindow::ProbeWindow(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+void ProbeWindow::push(const ProbeSample& sample) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.size() == capacity_) samples_.pop_front();
+    samples_.push_back(sample);
+}
+
+std::vector<ProbeSample> ProbeWindow::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<ProbeSample>(samples_.begin(), samples_.end());
+}
+
+ResultSocket::ResultSocket(const std::string& path, std::function<std::string()> render)
+    : path_(path), render_(std::move(render)), listen_fd_(-1), wake_fd_(-1), stopping_(false) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid socket path '" + path + "'");
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    
+    // Only ever replace a socket, never some other file at the same path
+    struct stat existing;
+    if (lstat(path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) unlink(path.c_str());
+    
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) throw std::runtime_error(errno_message("socket failed"));
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd_, 16) != 0) {
+        std::string message = errno_message("Cannot listen on " + path);
+        close(listen_fd_);
+        throw std::runtime_error(message);
+    }
+    wake_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        std::string message = errno_message("eventfd failed");
+        close(listen_fd_);
+        unlink(path.c_str());
+        throw std::runtime_error(message);
+    }
+}
+
+ResultSocket::~ResultSocket() {
+    stop();
+    close(listen_fd_);
+    close(wake_fd_);
+    unlink(path_.c_str());
+}
+
+void ResultSocket::start() {
+    thread_ = std::thread(&ResultSocket::serve, this);
+}
+
+void ResultSocket::stop() {
+    stopping_ = true;
+    uint64_t one = 1;
+    if (write(wake_fd_, &one, sizeof(one)) < 0) {
+        SafeOutput::error(errno_message("[DAEMON] Cannot wake result socket"));
+    }
+    if (thread_.joinable()) thread_.join();
+}
+
+void ResultSocket::serve() {
+    pollfd fds[2] = {
+        { listen_fd_, POLLIN, 0 },
+        { wake_fd_, POLLIN, 0 },
+    };
+    while (!stopping_) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            SafeOutput::error(errno_message("[DAEMON] poll failed"));
+            break;
+        }
+        if (!(fds[0].revents & POLLIN)) continue;
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        
+        // A client that stops reading must not wedge the server
+        timeval timeout = { 1, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        std::string text = render_();
+        const char* data = text.data();
+        size_t left = text.size();
+        while (left > 0) {
+            ssize_t sent = send(fd, data, left, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent <= 0) break;
+            data += sent;
+            left -= static_cast<size_t>(sent);
+        }
+        close(fd);
+    }
+}
+
+// Runs micro-probes every interval until SIGINT or SIGTERM. Everything
+// runs at SCHED_IDLE and nice 19, so any real work on the host preempts
+// it, and a round is skipped outright while the host is busier than the
+// configured utilization; consecutive skips back the schedule off
+// exponentially. The CPU probe walks the cores one round at a time, so a
+// single degrading core shows up in the window.
+void PCTester::Impl::run_daemon() {
+    // Both calls affect the calling thread only; threads the probes start
+    // inherit policy and nice value from it
+    if (setpriority(PRIO_PROCESS, 0, 19) != 0) {
+        SafeOutput::error(errno_message("[DAEMON] Cannot lower priority"));
+    }
+    sched_param idle{};
+    if (sched_setscheduler(0, SCHED_IDLE, &idle) != 0) {
+        SafeOutput::error(errno_message("[DAEMON] Cannot switch to SCHED_IDLE"));
+    }
+    
+    stop_requested = 0;
+    struct sigaction action{};
+    action.sa_handler = request_stop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    
+    std::vector<int> cpus = worker_cpus();
+    size_t working_set = std::min(dram_working_set(), kProbeMaxBytes);
+    size_t elements = (working_set / sizeof(double)) & ~size_t(7);
+    double interval = std::max(config.daemon_interval_s, 1.0);
+    
+    ProbeWindow window(config.daemon_window);
+    std::atomic<uint64_t> rounds(0);
+    std::atomic<uint64_t> skipped(0);
+    std::atomic<int> backoff(1);
+    ResultSocket socket(config.daemon_socket, [&]() {
+        std::stringstream out;
+        JsonLinesWriter writer(out);
+        writer.begin("daemon");
+        writer.field("interval_s", interval);
+        writer.field("max_util_pct", config.daemon_max_util_pct);
+        writer.field("backoff", backoff.load());
+        writer.field("rounds", static_cast<double>(rounds.load()));
+        writer.field("skipped", static_cast<double>(skipped.load()));
+        writer.end();
+        for (const ProbeSample& sample : window.snapshot()) {
+            writer.begin("probe");
+            writer.field("time", sample.time_s);
+            writer.id("probe", sample.probe);
+            writer.id("cpu", sample.cpu);
+            writer.field("value", sample.value);
+            writer.field("unit", sample.unit);
+            writer.field("host_util_pct", sample.host_util_pct);
+            writer.end();
+        }
+        return out.str();
+    });
+    socket.start();
+    
+    std::stringstream info;
+    info << "[DAEMON] Probing every " << interval << " s, skipping above " << config.daemon_max_util_pct
+         << "% host CPU; results on " << config.daemon_socket << " (Ctrl+C to stop)";
+    SafeOutput::print(info.str());
+    
+    // Each reading covers the time since the previous one, so the reading
+    // taken right after a round keeps the probes out of the next decision
+    telemetry.latest();
+    size_t next_cpu = 0;
+    while (!stop_requested) {
+        double util = telemetry.latest().cpu_util_pct;
+        if (util > config.daemon_max_util_pct) {
+            skipped++;
+            backoff = std::min(backoff.load() * 2, kMaxBackoff);
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(1) << "[DAEMON] Host at " << util << "% CPU, next round in "
+               << interval * backoff.load() << " s";
+            SafeOutput::print(ss.str());
+        } else {
+            backoff = 1;
+            int cpu = cpus[next_cpu++ % cpus.size()];
+            double now = unix_time_s();
+            double score = run_cpu_workers({ cpu }, kProbeCpuSeconds)[0];
+            window.push({ now, "cpu", cpu, score, "Mterms/s", util });
+            double triad = run_stream({ cpu }, elements).triad_gbs;
+            window.push({ now, "memory_bandwidth", cpu, triad, "GB/s", util });
+            double latency = chase_latency_ns(working_set, kProbeLatencyLoads);
+            window.push({ now, "memory_latency", -1, latency, "ns", util });
+            rounds++;
+            
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(1) << "[DAEMON] CPU " << cpu << ": " << score << " Mterms/s, triad "
+               << triad << " GB/s, latency " << latency << " ns";
+            SafeOutput::print(ss.str());
+            telemetry.latest();
+        }
+        if (metrics) metrics->publish("daemon", probe_metrics(window.snapshot(), rounds, skipped, backoff));
+        
+        auto wake = std::chrono::steady_clock::now() + std::chrono::duration<double>(interval * backoff.load());
+        while (!stop_requested && std::chrono::steady_clock::now() < wake) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(kWaitSliceSeconds));
+        }
+    }
+    
+    socket.stop();
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    SafeOutput::print("[DAEMON] Stopped after " + std::to_string(rounds.load()) + " round(s)");
+}
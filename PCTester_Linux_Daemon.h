@@ -0,0 +1,50 @@
+#pragma once
+
+#include "PCTester.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Rolling window of daemon probe results; once full, each new sample
+// drops the oldest
+class ProbeWindow {
+public:
+    explicit ProbeWindow(size_t capacity);
+    
+    void push(const ProbeSample& sample);
+    std::vector<ProbeSample> snapshot() const;
+    
+private:
+    size_t capacity_;
+    std::deque<ProbeSample> samples_;
+    mutable std::mutex mutex_;
+};
+
+// Unix stream socket that writes what render() returns to each client and
+// hangs up, so `nc -U <path>` or `socat - UNIX:<path>` prints the latest
+// results. Clients are served one at a time on a background thread; a
+// stale socket file is replaced on start and removed on stop.
+class ResultSocket {
+public:
+    ResultSocket(const std::string& path, std::function<std::string()> render);
+    ~ResultSocket();
+    ResultSocket(const ResultSocket&) = delete;
+    ResultSocket& operator=(const ResultSocket&) = delete;
+    
+    void start();
+    void stop();
+    
+private:
+    void serve();
+    
+    std::string path_;
+    std::function<std::string()> render_;
+    int listen_fd_;
+    int wake_fd_;
+    std::atomic<bool> stopping_;
+    std::thread thread_;
+};
@@ -0,0 +1,357 @@
+#include "PCTester_Linux.h"
+#include "PCTester_Linux_Disk.h"
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+namespace {
+
+const size_t kIoAlignment = 4096;
+const size_t kFillBlock = 1 << 20;
+const char* kScratchName = "pctester_disk.tmp";
+const char* kSyncScratchName = "pctester_sync.tmp";
+const size_t kSyncWriteSize = 4096;
+const off_t kSyncMaxFileSize = 64 << 20;
+
+enum SyncMode { kWriteFsync, kWriteFdatasync, kODsyncWrite };
+
+// Fills a buffer with incompressible bytes so drives that compress or
+// dedupe cannot shortcut the writes
+void fill_random(void* data, size_t bytes, uint64_t seed) {
+    uint64_t state = seed | 1;
+    uint64_t* words = static_cast<uint64_t*>(data);
+    for (size_t i = 0; i < bytes / sizeof(uint64_t); i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        words[i] = state;
+    }
+}
+
+} // namespace
+
+AlignedBuffer::AlignedBuffer(size_t bytes) : data_(nullptr), size_(bytes) {
+    if (posix_memalign(&data_, kIoAlignment, bytes) != 0) {
+        throw std::runtime_error("Failed to allocate aligned I/O buffer");
+    }
+    fill_random(data_, bytes, reinterpret_cast<uintptr_t>(data_));
+}
+
+AlignedBuffer::~AlignedBuffer() {
+    free(data_);
+}
+
+IoOffsetGenerator::IoOffsetGenerator(const IoJob& job, int slot)
+    : random_(job.profile.random), block_size_(job.profile.block_size), cursor_(0) {
+    uint64_t total_blocks = job.file_size / block_size_;
+    if (random_) {
+        first_block_ = 0;
+        blocks_ = total_blocks;
+    } else {
+        blocks_ = std::max<uint64_t>(1, total_blocks / job.profile.queue_depth);
+        first_block_ = (slot * blocks_) % std::max<uint64_t>(1, total_blocks);
+    }
+    state_ = 0x9e3779b97f4a7c15ull * (slot + 1);
+}
+
+uint64_t IoOffsetGenerator::next() {
+    uint64_t block;
+    if (random_) {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        block = state_ % blocks_;
+    } else {
+        block = first_block_ + cursor_;
+        cursor_ = (cursor_ + 1) % blocks_;
+    }
+    return block * block_size_;
+}
+
+IoRunStats ThreadPoolIoEngine::run(const IoJob& job) {
+    const int depth = job.profile.queue_depth;
+    std::vector<IoRunStats> per_slot(depth);
+    std::vector<std::thread> slots;
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::atomic<int> failure(0);
+    auto start = std::chrono::steady_clock::now();
+    
+    for (int slot = 0; slot < depth; slot++) {
+        slots.emplace_back([&, slot]() {
+            AlignedBuffer buffer(job.profile.block_size);
+            IoOffsetGenerator offsets(job, slot);
+            IoRunStats& stats = per_slot[slot];
+            
+            ready++;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            auto deadline = start + std::chrono::duration<double>(job.seconds);
+            
+            auto now = std::chrono::steady_clock::now();
+            while (now < deadline && failure.load(std::memory_order_relaxed) == 0) {
+                uint64_t offset = offsets.next();
+                auto issued = now;
+                ssize_t done = job.profile.write
+                    ? pwrite(job.fd, buffer.data(), job.profile.block_size, offset)
+                    : pread(job.fd, buffer.data(), job.profile.block_size, offset);
+                now = std::chrono::steady_clock::now();
+                if (done != static_cast<ssize_t>(job.profile.block_size)) {
+                    failure = done < 0 ? errno : EIO;
+                    break;
+                }
+                stats.latency_ns.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - issued).count());
+                stats.bytes += done;
+                stats.ios++;
+            }
+        });
+    }
+    
+    while (ready < depth) std::this_thread::yield();
+    start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& slot : slots) slot.join();
+    
+    IoRunStats total;
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (failure != 0) {
+        throw std::runtime_error(job.profile.name + " failed: " + strerror(failure));
+    }
+    for (auto& stats : per_slot) {
+        total.bytes += stats.bytes;
+        total.ios += stats.ios;
+        total.latency_ns.merge(stats.latency_ns);
+    }
+    return total;
+}
+
+std::unique_ptr<IoEngine> make_io_engine(const std::string& preference, bool sqpoll) {
+    if (preference != "threads") {
+        if (UringIoEngine::available()) return std::make_unique<UringIoEngine>(sqpoll);
+        if (preference == "io_uring") {
+            SafeOutput::error("[DISK] io_uring is unavailable, falling back to the thread-pool engine");
+        }
+    }
+    return std::make_unique<ThreadPoolIoEngine>();
+}
+
+DiskProfileResult summarize_io_run(const IoProfile& profile, const IoRunStats& stats) {
+    DiskProfileResult result{};
+    result.name = profile.name;
+    result.block_size = profile.block_size;
+    result.queue_depth = profile.queue_depth;
+    if (stats.seconds > 0.0) {
+        result.mbps = stats.bytes / stats.seconds / 1e6;
+        result.iops = stats.ios / stats.seconds;
+    }
+    result.p50_us = stats.latency_ns.percentile(0.50) / 1e3;
+    result.p99_us = stats.latency_ns.percentile(0.99) / 1e3;
+    result.p999_us = stats.latency_ns.percentile(0.999) / 1e3;
+    return result;
+}
+
+// Directory for scratch files on the disk under test: the target itself
+// if it is a directory, the file's parent for a regular file, and none for
+// a block device, which is never written to
+std::string PCTester::Impl::scratch_directory() const {
+    struct stat st;
+    if (stat(config.disk_path.c_str(), &st) != 0) return "";
+    if (S_ISDIR(st.st_mode)) return config.disk_path;
+    if (!S_ISREG(st.st_mode)) return "";
+    size_t slash = config.disk_path.find_last_of('/');
+    return slash == std::string::npos ? "." : config.disk_path.substr(0, std::max<size_t>(slash, 1));
+}
+
+void PCTester::Impl::disk_test() {
+    SafeOutput::print("\n[DISK] Starting O_DIRECT storage test...");
+    
+    struct stat st;
+    if (stat(config.disk_path.c_str(), &st) != 0) {
+        SafeOutput::error("[DISK] Cannot access " + config.disk_path + ": " + strerror(errno));
+        return;
+    }
+    
+    // A directory gets a scratch file we create and remove; an existing
+    // file is only overwritten on request; a block device is never written to
+    std::string path = config.disk_path;
+    bool scratch = S_ISDIR(st.st_mode);
+    bool read_only = S_ISBLK(st.st_mode) || (S_ISREG(st.st_mode) && !config.disk_write_file);
+    uint64_t file_size = 0;
+    if (scratch) {
+        path += "/" + std::string(kScratchName);
+        struct statvfs fs;
+        file_size = config.disk_file_size;
+        if (statvfs(config.disk_path.c_str(), &fs) == 0) {
+            file_size = std::min<uint64_t>(file_size, fs.f_bavail * fs.f_frsize / 2);
+        }
+    } else if (S_ISREG(st.st_mode)) {
+        file_size = st.st_size;
+    } else if (!read_only) {
+        SafeOutput::error("[DISK] " + config.disk_path + " is not a directory, file or block device");
+        return;
+    }
+    
+    int fd = open(path.c_str(), (read_only ? O_RDONLY : O_RDWR) | (scratch ? O_CREAT : 0) | O_DIRECT, 0600);
+    if (fd < 0) {
+        // EINVAL here means the filesystem (e.g. tmpfs) has no O_DIRECT support;
+        // falling back to buffered I/O would only measure the page cache
+        SafeOutput::error("[DISK] Cannot open " + path + " with O_DIRECT: " + strerror(errno));
+        return;
+    }
+    if (S_ISBLK(st.st_mode)) ioctl(fd, BLKGETSIZE64, &file_size);
+    if (read_only) {
+        SafeOutput::print("[DISK] Existing " + std::string(S_ISBLK(st.st_mode) ? "device" : "file") +
+                          " is only read; write profiles skipped");
+    }
+    file_size -= file_size % kFillBlock;
+    if (file_size < kFillBlock) {
+        SafeOutput::error("[DISK] Target is too small for the disk test");
+        close(fd);
+        if (scratch) unlink(path.c_str());
+        return;
+    }
+    
+    try {
+        // Write real data first so reads hit allocated blocks, not holes
+        if (scratch) {
+            SafeOutput::print("[DISK] Preparing " + std::to_string(file_size >> 20) + " MiB test file in " + config.disk_path);
+            AlignedBuffer block(kFillBlock);
+            for (uint64_t offset = 0; offset < file_size; offset += kFillBlock) {
+                if (pwrite(fd, block.data(), kFillBlock, offset) != static_cast<ssize_t>(kFillBlock)) {
+                    throw std::runtime_error(std::string("Failed to prepare test file: ") + strerror(errno));
+                }
+            }
+            fsync(fd);
+        }
+        
+        std::unique_ptr<IoEngine> engine = make_io_engine(config.disk_engine, config.disk_sqpoll);
+        SafeOutput::print("[DISK] Engine: " + std::string(engine->name()));
+        
+        std::vector<IoProfile> profiles = {
+            { "Sequential read", false, false, 1 << 20, 1 },
+            { "Sequential write", true, false, 1 << 20, 1 },
+        };
+        for (int depth : { 1, 4, 16, 64 }) {
+            profiles.push_back({ "Random read", false, true, 4096, depth });
+        }
+        for (int depth : { 1, 4, 16, 64 }) {
+            profiles.push_back({ "Random write", true, true, 4096, depth });
+        }
+        
+        test_results.disk_profiles.clear();
+        for (const auto& profile : profiles) {
+            if (profile.write && read_only) continue;
+            
+            IoJob job{ fd, file_size, profile, config.disk_seconds };
+            IoRunStats stats = engine->run(job);
+            DiskProfileResult result = summarize_io_run(profile, stats);
+            // SQPOLL may have been dropped on the first run if not permitted
+            test_results.disk_engine = engine->name();
+            test_results.disk_profiles.push_back(result);
+            
+            if (!profile.random && !profile.write) test_results.disk_read = result.mbps;
+            if (!profile.random && profile.write) test_results.disk_write = result.mbps;
+            
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(1);
+            ss << "[DISK] " << std::left << std::setw(17) << result.name << std::right
+               << std::setw(5) << (result.block_size >> 10) << "K QD" << result.queue_depth
+               << "  " << result.mbps << " MB/s  " << std::setprecision(0) << result.iops << " IOPS"
+               << std::setprecision(1) << "  p50 " << result.p50_us << "us  p99 " << result.p99_us
+               << "us  p99.9 " << result.p999_us << "us";
+            SafeOutput::print(ss.str());
+        }
+        
+        // The flush test needs a writable directory next to the target
+        std::string directory = scratch_directory();
+        if (!directory.empty()) disk_sync_test(directory);
+    } catch (const std::exception& e) {
+        SafeOutput::error("[DISK] " + std::string(e.what()));
+    }
+    
+    close(fd);
+    if (scratch) unlink(path.c_str());
+}
+
+// Appends small records and forces each one to stable storage, the way a
+// database commit log does. Every append+flush pair is recorded, so the
+// tail of the distribution is exact rather than sampled.
+void PCTester::Impl::disk_sync_test(const std::string& directory) {
+    SafeOutput::print("[DISK] Measuring flush latency (" + std::to_string(kSyncWriteSize) + " byte appends)...");
+    
+    const std::pair<SyncMode, const char*> modes[] = {
+        { kWriteFsync, "write + fsync" },
+        { kWriteFdatasync, "write + fdatasync" },
+        { kODsyncWrite, "O_DSYNC write" },
+    };
+    std::string path = directory + "/" + kSyncScratchName;
+    AlignedBuffer record(kSyncWriteSize);
+    
+    test_results.disk_sync_results.clear();
+    for (const auto& mode : modes) {
+        int flags = O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | (mode.first == kODsyncWrite ? O_DSYNC : 0);
+        int fd = open(path.c_str(), flags, 0600);
+        if (fd < 0) {
+            SafeOutput::error("[DISK] Cannot create " + path + ": " + strerror(errno));
+            return;
+        }
+        
+        LatencyHistogram latency;
+        off_t written = 0;
+        int failure = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(config.disk_seconds);
+        auto now = std::chrono::steady_clock::now();
+        while (now < deadline) {
+            // Keep the file bounded; truncation happens outside the timed region
+            if (written >= kSyncMaxFileSize) {
+                if (ftruncate(fd, 0) != 0) { failure = errno; break; }
+                fsync(fd);
+                written = 0;
+                now = std::chrono::steady_clock::now();
+            }
+            
+            auto issued = now;
+            if (write(fd, record.data(), kSyncWriteSize) != static_cast<ssize_t>(kSyncWriteSize)) { failure = errno; break; }
+            if (mode.first == kWriteFsync && fsync(fd) != 0) { failure = errno; break; }
+            if (mode.first == kWriteFdatasync && fdatasync(fd) != 0) { failure = errno; break; }
+            now = std::chrono::steady_clock::now();
+            
+            latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - issued).count());
+            written += kSyncWriteSize;
+        }
+        close(fd);
+        unlink(path.c_str());
+        
+        if (failure != 0) {
+            SafeOutput::error("[DISK] " + std::string(mode.second) + " failed: " + strerror(failure));
+            continue;
+        }
+        
+        SyncLatencyResult result{};
+        result.mode = mode.second;
+        result.write_size = kSyncWriteSize;
+        result.count = latency.count();
+        result.mean_us = latency.mean() / 1e3;
+        result.p50_us = latency.percentile(0.50) / 1e3;
+        result.p90_us = latency.percentile(0.90) / 1e3;
+        result.p99_us = latency.percentile(0.99) / 1e3;
+        result.p999_us = latency.percentile(0.999) / 1e3;
+        result.max_us = latency.max() / 1e3;
+        for (const auto& bucket : latency.log2_buckets()) {
+            result.buckets.emplace_back(bucket.first / 1e3, bucket.second);
+        }
+        test_results.disk_sync_results.push_back(result);
+        
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1);
+        ss << "[DISK] " << std::left << std::setw(18) << result.mode << std::right << result.count << " ops  mean "
+           << result.mean_us << "us  p50 " << result.p50_us << "us  p99 " << result.p99_us << "us  p99.9 "
+           << result.p999_us << "us  max " << result.max_us << "us";
+        SafeOutput::print(ss.str());
+    }
+}
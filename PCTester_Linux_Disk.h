@@ -0,0 +1,106 @@
+#pragma once
+
+#include "PCTester.h"
+#include "PCTester_Histogram.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Shape of one disk measurement
+struct IoProfile {
+    std::string name;
+    bool write;
+    bool random;
+    size_t block_size;
+    int queue_depth;
+};
+
+// Everything an engine needs to drive one profile against an open file
+struct IoJob {
+    int fd;
+    uint64_t file_size;
+    IoProfile profile;
+    double seconds;
+};
+
+// Raw outcome of a profile: bytes moved, wall time and the completion
+// latency of every I/O in nanoseconds
+struct IoRunStats {
+    uint64_t bytes = 0;
+    uint64_t ios = 0;
+    double seconds = 0.0;
+    LatencyHistogram latency_ns;
+};
+
+// Page-aligned heap buffer as required by O_DIRECT
+class AlignedBuffer {
+public:
+    explicit AlignedBuffer(size_t bytes);
+    ~AlignedBuffer();
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+    
+    void* data() const { return data_; }
+    size_t size() const { return size_; }
+    
+private:
+    void* data_;
+    size_t size_;
+};
+
+// Block offsets for one in-flight slot of a job. Random profiles pick
+// uniformly from the whole file; sequential ones walk a private segment
+// per slot so parallel streams never overlap.
+class IoOffsetGenerator {
+public:
+    IoOffsetGenerator(const IoJob& job, int slot);
+    uint64_t next();
+    
+private:
+    bool random_;
+    uint64_t block_size_;
+    uint64_t first_block_;
+    uint64_t blocks_;
+    uint64_t cursor_;
+    uint64_t state_;
+};
+
+// Disk I/O backend. Engines only differ in how they keep queue_depth
+// requests in flight; offsets, buffers and accounting follow the job.
+class IoEngine {
+public:
+    virtual ~IoEngine() = default;
+    virtual const char* name() const = 0;
+    virtual IoRunStats run(const IoJob& job) = 0;
+};
+
+// Keeps queue_depth synchronous pread/pwrite calls in flight, one thread each
+class ThreadPoolIoEngine : public IoEngine {
+public:
+    const char* name() const override { return "thread-pool pread/pwrite"; }
+    IoRunStats run(const IoJob& job) override;
+};
+
+// Asynchronous engine on io_uring, driven through raw syscalls. Uses
+// registered buffers and files, batches every refill into one submission
+// and can hand submission to a kernel SQ polling thread.
+class UringIoEngine : public IoEngine {
+public:
+    explicit UringIoEngine(bool sqpoll) : sqpoll_(sqpoll) {}
+    const char* name() const override { return sqpoll_ ? "io_uring (SQPOLL)" : "io_uring"; }
+    IoRunStats run(const IoJob& job) override;
+    
+    // False on kernels without io_uring or where it is blocked by policy
+    static bool available();
+    
+private:
+    bool sqpoll_;
+};
+
+// Picks an engine: "io_uring", "threads", or "auto" for io_uring when the
+// kernel allows it and the thread pool otherwise
+std::unique_ptr<IoEngine> make_io_engine(const std::string& preference, bool sqpoll);
+
+// Turns raw stats into the reported MB/s, IOPS and latency percentiles
+DiskProfileResult summarize_io_run(const IoProfile& profile, const IoRunStats& stats);
@@ -0,0 +1,295 @@
+#include "PCTester_Linux.h"
+#include "PCTester_Linux_Network.h"
+#include "PCTester_Histogram.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+
+namespace {
+
+const int kEpollBatch = 256;
+const int kEpollTimeoutMs = 20;      // bounds how late a loop notices stop
+const int kReservedFds = 64;         // stdio, listeners, epoll and friends
+
+using clock_type = std::chrono::steady_clock;
+
+// Raises the soft RLIMIT_NOFILE as far as the hard limit allows and
+// returns the resulting limit
+uint64_t raise_fd_limit(uint64_t wanted) {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return 1024;
+    if (limit.rlim_cur < wanted) {
+        limit.rlim_cur = std::min<rlim_t>(wanted, limit.rlim_max);
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    return limit.rlim_cur;
+}
+
+void set_nonblocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+// Reset instead of FIN, so thousands of client ports do not sit in
+// TIME_WAIT and starve the next run of ephemeral ports
+void abort_close(int fd) {
+    linger option = { 1, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_LINGER, &option, sizeof(option));
+    close(fd);
+}
+
+struct ServerLoopStats {
+    int connections = 0;
+    uint64_t bytes = 0;
+};
+
+// Echo server loop over its own SO_REUSEPORT listener. Echoing raw bytes
+// keeps request framing intact without any per-connection state.
+void run_server_loop(int listen_fd, const std::atomic<bool>& stop, ServerLoopStats& stats) {
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+    
+    std::vector<int> open_fds;
+    epoll_event events[kEpollBatch];
+    char buffer[4096];
+    while (!stop.load(std::memory_order_relaxed)) {
+        int ready = epoll_wait(epoll_fd, events, kEpollBatch, kEpollTimeoutMs);
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listen_fd) {
+                int client;
+                while ((client = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                    int one = 1;
+                    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    event.events = EPOLLIN;
+                    event.data.fd = client;
+                    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client, &event);
+                    open_fds.push_back(client);
+                    stats.connections++;
+                }
+                continue;
+            }
+            ssize_t bytes = recv(fd, buffer, sizeof(buffer), 0);
+            if (bytes > 0) {
+                // One request per connection is in flight, so the send
+                // buffer always has room for the echo
+                if (send(fd, buffer, bytes, MSG_NOSIGNAL) == bytes) stats.bytes += bytes;
+            } else if (bytes == 0 || (errno != EAGAIN && errno != EINTR)) {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+            }
+        }
+    }
+    for (int fd : open_fds) close(fd);
+    close(epoll_fd);
+}
+
+struct ClientConnection {
+    int fd;
+    size_t received;
+    clock_type::time_point sent;
+};
+
+struct ClientLoopStats {
+    uint64_t requests = 0;
+    LatencyHistogram latency_ns;
+    std::string error;
+};
+
+// Opens its share of connections, then keeps one small request in flight
+// on each of them until the deadline
+void run_client_loop(const NetAddress& peer, int connections, std::atomic<int>& ready,
+                     const std::atomic<bool>& go, const clock_type::time_point& deadline,
+                     ClientLoopStats& stats) {
+    std::vector<ClientConnection> conns;
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    for (int i = 0; i < connections; i++) {
+        int fd = socket(peer.storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&peer.storage), peer.length) != 0) {
+            stats.error = std::string("connect failed after ") + std::to_string(conns.size()) +
+                          " connections: " + strerror(errno);
+            if (fd >= 0) close(fd);
+            break;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        set_nonblocking(fd);
+        conns.push_back({ fd, 0, clock_type::time_point() });
+    }
+    for (size_t i = 0; i < conns.size(); i++) {
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conns[i].fd, &event);
+    }
+    
+    ready++;
+    while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+    
+    char message[kNetMessageSize] = {};
+    for (auto& conn : conns) {
+        conn.sent = clock_type::now();
+        send(conn.fd, message, sizeof(message), MSG_NOSIGNAL);
+    }
+    
+    epoll_event events[kEpollBatch];
+    while (clock_type::now() < deadline) {
+        int count = epoll_wait(epoll_fd, events, kEpollBatch, kEpollTimeoutMs);
+        auto now = clock_type::now();
+        for (int i = 0; i < count; i++) {
+            ClientConnection& conn = conns[events[i].data.u64];
+            ssize_t bytes = recv(conn.fd, message, kNetMessageSize - conn.received, 0);
+            if (bytes <= 0) continue;
+            conn.received += bytes;
+            if (conn.received < kNetMessageSize) continue;
+            
+            stats.latency_ns.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - conn.sent).count());
+            stats.requests++;
+            conn.received = 0;
+            if (now < deadline) {
+                conn.sent = now;
+                send(conn.fd, message, sizeof(message), MSG_NOSIGNAL);
+            }
+        }
+    }
+    
+    for (auto& conn : conns) abort_close(conn.fd);
+    close(epoll_fd);
+}
+
+} // namespace
+
+// Thousands of loopback connections, each with one 64-byte request in
+// flight, against one epoll echo loop per core. The kernel spreads
+// connections over the loops' SO_REUSEPORT listeners, so per-loop rates
+// show how evenly that hashing balances load.
+void PCTester::Impl::network_stress_test() {
+    SafeOutput::print("\n[NET] Starting connection stress test...");
+    
+    std::vector<int> cpus = online_cpus();
+    int loops = static_cast<int>(cpus.size());
+    
+    // Both ends of every connection live in this process
+    uint64_t wanted = 2ull * config.network_stress_connections + kReservedFds + 4ull * loops;
+    uint64_t limit = raise_fd_limit(wanted);
+    int connections = config.network_stress_connections;
+    if (limit < wanted) {
+        connections = static_cast<int>((limit - std::min<uint64_t>(limit, kReservedFds + 4ull * loops)) / 2);
+        SafeOutput::print("[NET] RLIMIT_NOFILE is " + std::to_string(limit) + ", limiting the test to " +
+                          std::to_string(connections) + " connections");
+    }
+    if (connections < loops) {
+        SafeOutput::error("[NET] Not enough file descriptors for the connection stress test");
+        return;
+    }
+    
+    // The first listener picks the port, the rest join its reuseport group
+    std::vector<int> listeners;
+    NetAddress address = NetAddress::resolve("127.0.0.1", 0, false);
+    for (int i = 0; i < loops; i++) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+        if (fd < 0 || bind(fd, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0 ||
+            listen(fd, SOMAXCONN) != 0) {
+            SafeOutput::error("[NET] Cannot create SO_REUSEPORT listener: " + std::string(strerror(errno)));
+            if (fd >= 0) close(fd);
+            for (int listener : listeners) close(listener);
+            return;
+        }
+        if (i == 0) {
+            socklen_t length = address.length;
+            getsockname(fd, reinterpret_cast<sockaddr*>(&address.storage), &length);
+        }
+        listeners.push_back(fd);
+    }
+    
+    std::atomic<bool> stop_servers(false);
+    std::vector<ServerLoopStats> server_stats(loops);
+    std::vector<std::thread> servers;
+    for (int i = 0; i < loops; i++) {
+        servers.emplace_back([&, i]() {
+            pin_thread_to_cpu(cpus[i]);
+            run_server_loop(listeners[i], stop_servers, server_stats[i]);
+        });
+    }
+    
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    clock_type::time_point deadline;
+    std::vector<ClientLoopStats> client_stats(loops);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < loops; i++) {
+        int share = connections / loops + (i < connections % loops ? 1 : 0);
+        clients.emplace_back([&, i, share]() {
+            pin_thread_to_cpu(cpus[i]);
+            run_client_loop(address, share, ready, go, deadline, client_stats[i]);
+        });
+    }
+    while (ready.load() < loops) std::this_thread::yield();
+    
+    auto start = clock_type::now();
+    deadline = start + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(config.network_seconds));
+    go.store(true, std::memory_order_release);
+    for (auto& client : clients) client.join();
+    double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    
+    stop_servers = true;
+    for (auto& server : servers) server.join();
+    for (int listener : listeners) close(listener);
+    
+    LatencyHistogram latency;
+    uint64_t requests = 0;
+    for (const auto& stats : client_stats) {
+        if (!stats.error.empty()) SafeOutput::error("[NET] " + stats.error);
+        latency.merge(stats.latency_ns);
+        requests += stats.requests;
+    }
+    
+    // Servers also echo the requests still in flight at the deadline, so
+    // their counts only set each loop's share of the client-side rate
+    uint64_t echoed = 0;
+    for (const auto& stats : server_stats) echoed += stats.bytes;
+    
+    test_results.network_stress_loops.clear();
+    int opened = 0;
+    double busiest = 0.0, slowest = 0.0;
+    for (int i = 0; i < loops; i++) {
+        EventLoopResult loop;
+        loop.cpu = cpus[i];
+        loop.connections = server_stats[i].connections;
+        loop.requests_per_sec = echoed ? requests / seconds * server_stats[i].bytes / echoed : 0.0;
+        test_results.network_stress_loops.push_back(loop);
+        opened += loop.connections;
+        busiest = std::max(busiest, loop.requests_per_sec);
+        slowest = i == 0 ? loop.requests_per_sec : std::min(slowest, loop.requests_per_sec);
+    }
+    
+    test_results.network_stress_connections = opened;
+    test_results.network_stress_rps = requests / seconds;
+    test_results.network_stress_p50_us = latency.percentile(0.50) / 1000.0;
+    test_results.network_stress_p99_us = latency.percentile(0.99) / 1000.0;
+    test_results.network_stress_p999_us = latency.percentile(0.999) / 1000.0;
+    test_results.network_stress_balance = busiest > 0 ? slowest / busiest : 0.0;
+    
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "[NET] " << opened << " connections over " << loops << " event loops: "
+       << test_results.network_stress_rps / 1000.0 << " k requests/s\n";
+    ss << "[NET] Latency: p50 " << test_results.network_stress_p50_us << " us, p99 "
+       << test_results.network_stress_p99_us << " us, p99.9 " << test_results.network_stress_p999_us << " us\n";
+    ss << "[NET] Loop balance (slowest/busiest): " << std::setprecision(2) << test_results.network_stress_balance;
+    for (const auto& loop : test_results.network_stress_loops) {
+        ss << "\n[NET]   CPU " << std::setw(3) << loop.cpu << ": " << std::setw(6) << loop.connections
+           << " connections, " << std::setprecision(1) << std::setw(8) << loop.requests_per_sec / 1000.0 << " k requests/s";
+    }
+    SafeOutput::print(ss.str());
+}
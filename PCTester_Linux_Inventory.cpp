@@ -0,0 +1,420 @@
+#include "PCTester_Linux.h"
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <set>
+#include <string_view>
+#include <sys/sysinfo.h>
+#include <unistd.h>
+
+namespace {
+
+// Largest file read whole; pci.ids is the only one that comes close
+const size_t kMaxFileBytes = 4ull << 20;
+
+// Only the first processor block of /proc/cpuinfo is needed
+const size_t kCpuinfoHeadBytes = 16 << 10;
+
+const char* const kPciIdsPaths[] = {
+    "/usr/share/hwdata/pci.ids", "/usr/share/misc/pci.ids", "/usr/share/pci.ids"
+};
+
+// IORESOURCE_MEM in a PCI resource line's flags
+const uint64_t kResourceMem = 0x200;
+
+// Reads a procfs or sysfs file with one open and, for anything up to a
+// page, one read into a buffer the caller reuses across files. False when
+// the file cannot be opened or read, e.g. root-only DMI tables.
+bool read_file(const std::string& path, std::string& buffer, size_t limit = kMaxFileBytes) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    buffer.resize(std::min<size_t>(limit, 4096));
+    size_t used = 0;
+    bool ok = true;
+    while (used < limit) {
+        if (used == buffer.size()) buffer.resize(std::min(limit, buffer.size() * 2));
+        ssize_t n = read(fd, &buffer[used], buffer.size() - used);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) ok = false;
+        if (n <= 0) break;
+        used += static_cast<size_t>(n);
+    }
+    close(fd);
+    buffer.resize(used);
+    return ok;
+}
+
+std::string_view trim(std::string_view text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string_view::npos) return std::string_view();
+    return text.substr(begin, text.find_last_not_of(" \t\r\n") + 1 - begin);
+}
+
+// Decimal, or hex with an optional 0x prefix; 0 when unparsable
+uint64_t to_u64(std::string_view text, int base = 10) {
+    text = trim(text);
+    if (base == 16 && text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) text.remove_prefix(2);
+    uint64_t value = 0;
+    std::from_chars(text.data(), text.data() + text.size(), value, base);
+    return value;
+}
+
+// Value after the separator on the first line that starts with key, e.g.
+// "model name\t: Intel(R) ..." for key "model name" and ':'
+std::string_view line_value(std::string_view text, std::string_view key, char separator) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        std::string_view line = text.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        if (line.compare(0, key.size(), key) == 0) {
+            std::string_view rest = line.substr(key.size());
+            size_t sep = rest.find(separator);
+            if (sep != std::string_view::npos && trim(rest.substr(0, sep)).empty()) return trim(rest.substr(sep + 1));
+        }
+        if (end == std::string_view::npos) break;
+        pos = end + 1;
+    }
+    return std::string_view();
+}
+
+// One sysfs attribute, trimmed; empty when absent
+std::string read_attribute(const std::string& path, std::string& buffer) {
+    if (!read_file(path, buffer)) return std::string();
+    return std::string(trim(buffer));
+}
+
+// Entries of a directory that start with prefix, sorted
+std::vector<std::string> list_directory(const std::string& path, const char* prefix) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return names;
+    size_t prefix_length = strlen(prefix);
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.' || strncmp(entry->d_name, prefix, prefix_length) != 0) continue;
+        names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// "node12" -> 12, so node10 sorts after node9
+int numeric_suffix(const std::string& name) {
+    size_t digits = name.find_first_of("0123456789");
+    return digits == std::string::npos ? -1 : static_cast<int>(to_u64(std::string_view(name).substr(digits)));
+}
+
+// Fills PciDevice::name for every device whose vendor and device id
+// appear in the pci.ids database, reading it once
+void name_pci_devices(std::vector<PciDevice>& devices, std::string& buffer) {
+    bool loaded = false;
+    for (const char* path : kPciIdsPaths) {
+        if ((loaded = read_file(path, buffer))) break;
+    }
+    if (!loaded) return;
+
+    // Vendor lines start in column 0, device lines with one tab,
+    // subsystem lines with two; class tables start with "C "
+    std::string_view text(buffer);
+    std::string_view vendor_name;
+    int vendor = -1;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (line.empty() || line[0] == '#') continue;
+        if (line.compare(0, 2, "C ") == 0) break;
+        if (line[0] != '\t') {
+            vendor = static_cast<int>(to_u64(line.substr(0, 4), 16));
+            vendor_name = trim(line.substr(4));
+            for (PciDevice& device : devices) {
+                if (device.vendor_id == vendor && device.name.empty()) device.name = std::string(vendor_name);
+            }
+        } else if (line.size() > 6 && line[1] != '\t') {
+            int id = static_cast<int>(to_u64(line.substr(1, 4), 16));
+            for (PciDevice& device : devices) {
+                if (device.vendor_id == vendor && device.device_id == id) {
+                    device.name = std::string(vendor_name) + " " + std::string(trim(line.substr(5)));
+                }
+            }
+        }
+    }
+}
+
+// SMBIOS memory device (type 17) fields, per DSP0134
+std::string dmi_memory_type(uint8_t type) {
+    switch (type) {
+        case 0x12: return "DDR";
+        case 0x13: return "DDR2";
+        case 0x18: return "DDR3";
+        case 0x1A: return "DDR4";
+        case 0x1B: return "LPDDR";
+        case 0x1C: return "LPDDR2";
+        case 0x1D: return "LPDDR3";
+        case 0x1E: return "LPDDR4";
+        case 0x22: return "DDR5";
+        case 0x23: return "LPDDR5";
+        default: return "";
+    }
+}
+
+// Parses one raw type 17 structure; false for an empty slot
+bool parse_dmi_dimm(const std::string& raw, DimmInfo& dimm) {
+    auto byte = [&](size_t offset) { return static_cast<uint8_t>(raw[offset]); };
+    auto word = [&](size_t offset) { return static_cast<uint16_t>(byte(offset) | byte(offset + 1) << 8); };
+    if (raw.size() < 0x17 || byte(0) != 17) return false;
+    size_t length = byte(1);
+    if (length < 0x17 || raw.size() < length) return false;
+
+    // Strings follow the formatted area, numbered from 1
+    std::vector<std::string_view> strings;
+    for (size_t pos = length; pos < raw.size() && raw[pos] != '\0';) {
+        size_t end = raw.find('\0', pos);
+        if (end == std::string::npos) end = raw.size();
+        strings.push_back(trim(std::string_view(raw).substr(pos, end - pos)));
+        pos = end + 1;
+    }
+    auto string_at = [&](size_t offset) {
+        if (offset >= length) return std::string();
+        size_t index = byte(offset);
+        return index > 0 && index <= strings.size() ? std::string(strings[index - 1]) : std::string();
+    };
+
+    // 0x7FFF defers to the extended size in MB; bit 15 means KB units
+    uint16_t size = word(0x0C);
+    if (size == 0 || size == 0xFFFF) return false;
+    if (size == 0x7FFF && length >= 0x20) {
+        dimm.size = static_cast<uint64_t>(word(0x1C) | static_cast<uint32_t>(word(0x1E)) << 16) << 20;
+    } else if (size & 0x8000) {
+        dimm.size = static_cast<uint64_t>(size & 0x7FFF) << 10;
+    } else {
+        dimm.size = static_cast<uint64_t>(size) << 20;
+    }
+    dimm.locator = string_at(0x10);
+    dimm.type = dmi_memory_type(byte(0x12));
+    dimm.speed_mts = length >= 0x22 && word(0x20) ? word(0x20) : word(0x15);
+    dimm.manufacturer = string_at(0x17);
+    dimm.part_number = string_at(0x1A);
+    return true;
+}
+
+} // namespace
+
+void PCTester::Impl::collect_system_info() {
+    std::string buffer;
+
+    // "PRETTY_NAME="Debian GNU/Linux 12 (bookworm)""
+    if (read_file("/etc/os-release", buffer)) {
+        std::string_view name = line_value(buffer, "PRETTY_NAME", '=');
+        if (name.size() >= 2 && (name.front() == '"' || name.front() == '\'')) name = name.substr(1, name.size() - 2);
+        sys_info.os_name = std::string(name);
+    }
+
+    // Every processor block repeats the name; ARM kernels may only have
+    // "Hardware" or "Processor"
+    if (read_file("/proc/cpuinfo", buffer, kCpuinfoHeadBytes)) {
+        for (const char* key : { "model name", "Processor", "Hardware" }) {
+            std::string_view name = line_value(buffer, key, ':');
+            if (!name.empty()) {
+                sys_info.cpu_name = std::string(name);
+                break;
+            }
+        }
+    }
+
+    struct sysinfo memInfo;
+    sysinfo(&memInfo);
+    sys_info.memory_size = static_cast<uint64_t>(memInfo.totalram) * memInfo.mem_unit;
+
+    collect_cpu_topology();
+    collect_cache_info();
+    collect_numa_info();
+    collect_pci_devices();
+    collect_dimms();
+}
+
+// Cores are distinct (package, core id) pairs over the online CPUs, which
+// stays right on multi-socket hosts where /proc/cpuinfo's "cpu cores" is
+// per package
+void PCTester::Impl::collect_cpu_topology() {
+    std::string buffer;
+    std::vector<int> cpus;
+    if (read_file("/sys/devices/system/cpu/online", buffer)) cpus = parse_cpu_list(std::string(trim(buffer)));
+    if (cpus.empty()) cpus = online_cpus();
+
+    std::set<uint64_t> packages;
+    std::set<std::pair<uint64_t, uint64_t>> cores;
+    for (int cpu : cpus) {
+        std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        if (!read_file(dir + "physical_package_id", buffer)) continue;
+        uint64_t package = to_u64(buffer);
+        if (!read_file(dir + "core_id", buffer)) continue;
+        packages.insert(package);
+        cores.insert({ package, to_u64(buffer) });
+    }
+    sys_info.cpu_threads = cpus.size();
+    sys_info.cpu_cores = cores.empty() ? cpus.size() : cores.size();
+    sys_info.cpu_sockets = packages.empty() ? 1 : packages.size();
+}
+
+void PCTester::Impl::collect_cache_info() {
+    sys_info.caches.clear();
+    std::string buffer;
+    for (int index = 0; ; index++) {
+        std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        if (!read_file(dir + "level", buffer)) break;
+
+        CacheInfo cache{};
+        cache.level = static_cast<int>(to_u64(buffer));
+        cache.type = read_attribute(dir + "type", buffer);
+        cache.line_size = to_u64(read_attribute(dir + "coherency_line_size", buffer));
+        cache.shared_cpus = read_attribute(dir + "shared_cpu_list", buffer);
+
+        // Sizes are reported as e.g. "48K" or "36M"
+        std::string size = read_attribute(dir + "size", buffer);
+        if (!size.empty()) {
+            cache.size = to_u64(size.substr(0, size.find_first_not_of("0123456789")));
+            char unit = size.back();
+            if (unit == 'K') cache.size <<= 10;
+            else if (unit == 'M') cache.size <<= 20;
+            else if (unit == 'G') cache.size <<= 30;
+        }
+        sys_info.caches.push_back(cache);
+    }
+}
+
+// Expands a sysfs CPU list such as "0-3,8-11" into individual CPU ids
+std::vector<int> PCTester::Impl::parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::string_view text(list);
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        std::string_view range = trim(text.substr(0, comma));
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        int first = static_cast<int>(to_u64(range.substr(0, dash)));
+        int last = dash == std::string_view::npos ? first : static_cast<int>(to_u64(range.substr(dash + 1)));
+        for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+void PCTester::Impl::collect_numa_info() {
+    sys_info.numa_nodes.clear();
+    std::string buffer;
+    for (const std::string& name : list_directory("/sys/devices/system/node", "node")) {
+        if (!isdigit(static_cast<unsigned char>(name[4]))) continue;
+
+        NumaNode node{};
+        node.id = numeric_suffix(name);
+        std::string path = "/sys/devices/system/node/" + name + "/";
+        node.cpus = parse_cpu_list(read_attribute(path + "cpulist", buffer));
+
+        // "Node 0 MemTotal:        5603064 kB"
+        if (read_file(path + "meminfo", buffer)) {
+            size_t pos = buffer.find("MemTotal:");
+            if (pos != std::string::npos) {
+                std::string_view rest = trim(std::string_view(buffer).substr(pos + 9));
+                node.memory_size = to_u64(rest.substr(0, rest.find(' '))) * 1024;
+            }
+        }
+        sys_info.numa_nodes.push_back(node);
+    }
+
+    std::sort(sys_info.numa_nodes.begin(), sys_info.numa_nodes.end(),
+              [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+}
+
+// The GPU is the display-class device the firmware booted from, else the
+// first one. VRAM comes from amdgpu's counter where present, else the
+// largest memory BAR: all of VRAM with resizable BAR, the aperture without.
+void PCTester::Impl::collect_pci_devices() {
+    sys_info.pci_devices.clear();
+    sys_info.gpu_name.clear();
+    sys_info.gpu_memory = 0;
+
+    std::string buffer;
+    const std::string root = "/sys/bus/pci/devices/";
+    for (const std::string& address : list_directory(root, "")) {
+        std::string dir = root + address + "/";
+        PciDevice device{};
+        device.address = address;
+        device.class_code = static_cast<uint32_t>(to_u64(read_attribute(dir + "class", buffer), 16));
+        device.vendor_id = static_cast<uint16_t>(to_u64(read_attribute(dir + "vendor", buffer), 16));
+        device.device_id = static_cast<uint16_t>(to_u64(read_attribute(dir + "device", buffer), 16));
+        char target[256];
+        ssize_t length = readlink((dir + "driver").c_str(), target, sizeof(target) - 1);
+        if (length > 0) {
+            target[length] = '\0';
+            const char* slash = strrchr(target, '/');
+            device.driver = slash ? slash + 1 : target;
+        }
+        sys_info.pci_devices.push_back(device);
+    }
+    if (sys_info.pci_devices.empty()) return;
+    name_pci_devices(sys_info.pci_devices, buffer);
+
+    const PciDevice* gpu = nullptr;
+    for (const PciDevice& device : sys_info.pci_devices) {
+        if ((device.class_code >> 16) != 0x03) continue;
+        if (!gpu || read_attribute(root + device.address + "/boot_vga", buffer) == "1") gpu = &device;
+    }
+    if (!gpu) return;
+
+    char ids[16];
+    snprintf(ids, sizeof(ids), "%04x:%04x", gpu->vendor_id, gpu->device_id);
+    sys_info.gpu_name = gpu->name.empty() ? "PCI device " + std::string(ids) : gpu->name;
+
+    std::string dir = root + gpu->address + "/";
+    uint64_t vram = to_u64(read_attribute(dir + "mem_info_vram_total", buffer));
+    if (vram == 0 && read_file(dir + "resource", buffer)) {
+        // One "start end flags" line per BAR, all hex
+        std::string_view text(buffer);
+        while (!text.empty()) {
+            size_t end = text.find('\n');
+            std::string_view line = text.substr(0, end);
+            text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+            size_t first = line.find(' ');
+            size_t second = line.find(' ', first + 1);
+            if (second == std::string_view::npos) continue;
+            uint64_t start = to_u64(line.substr(0, first), 16);
+            uint64_t last = to_u64(line.substr(first + 1, second - first - 1), 16);
+            uint64_t flags = to_u64(line.substr(second + 1), 16);
+            if (start != 0 && last > start && (flags & kResourceMem)) vram = std::max(vram, last - start + 1);
+        }
+    }
+    sys_info.gpu_memory = vram >> 20;
+}
+
+// SMBIOS tables are usually root-only; EDAC exposes less but to everyone
+void PCTester::Impl::collect_dimms() {
+    sys_info.dimms.clear();
+    std::string buffer;
+    const std::string dmi = "/sys/firmware/dmi/entries/";
+    for (const std::string& entry : list_directory(dmi, "17-")) {
+        DimmInfo dimm{};
+        if (read_file(dmi + entry + "/raw", buffer) && parse_dmi_dimm(buffer, dimm)) sys_info.dimms.push_back(dimm);
+    }
+    if (!sys_info.dimms.empty()) return;
+
+    const std::string edac = "/sys/devices/system/edac/mc/";
+    for (const std::string& controller : list_directory(edac, "mc")) {
+        for (const std::string& name : list_directory(edac + controller, "dimm")) {
+            std::string dir = edac + controller + "/" + name + "/";
+            DimmInfo dimm{};
+            dimm.size = to_u64(read_attribute(dir + "size", buffer)) << 20;
+            if (dimm.size == 0) continue;
+            dimm.locator = read_attribute(dir + "dimm_label", buffer);
+            // "Registered-DDR4" -> "DDR4"
+            dimm.type = read_attribute(dir + "dimm_mem_type", buffer);
+            size_t dash = dimm.type.rfind('-');
+            if (dash != std::string::npos) dimm.type = dimm.type.substr(dash + 1);
+            sys_info.dimms.push_back(dimm);
+        }
+    }
+}
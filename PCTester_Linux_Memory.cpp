@@ -0,0 +1,483 @@
+#include "PCTester_Linux.h"
+#include "PCTester_Harness.h"
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#if defined(__x86_64__)
+    #include <emmintrin.h>
+#endif
+
+namespace {
+
+// Reusable barrier for a fixed set of pinned threads. Spinning keeps the
+// release-to-start skew far below what a condition variable would add.
+class SpinBarrier {
+public:
+    explicit SpinBarrier(size_t count) : count_(count), waiting_(0), generation_(0) {}
+    
+    void wait() {
+        size_t gen = generation_.load(std::memory_order_acquire);
+        if (waiting_.fetch_add(1, std::memory_order_acq_rel) + 1 == count_) {
+            waiting_.store(0, std::memory_order_relaxed);
+            generation_.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        while (generation_.load(std::memory_order_acquire) == gen) std::this_thread::yield();
+    }
+    
+private:
+    const size_t count_;
+    std::atomic<size_t> waiting_;
+    std::atomic<size_t> generation_;
+};
+
+// Binds a mapping to one NUMA node with the raw mbind syscall, so the
+// NUMA tests work without libnuma installed
+bool bind_to_node(void* addr, size_t bytes, int node) {
+    const size_t mask_bits = 1024;
+    unsigned long mask[mask_bits / (8 * sizeof(unsigned long))] = {};
+    if (node < 0 || static_cast<size_t>(node) >= mask_bits) return false;
+    mask[node / (8 * sizeof(unsigned long))] |= 1ul << (node % (8 * sizeof(unsigned long)));
+    // The kernel ignores the last bit of maxnode, hence the + 1
+    return syscall(SYS_mbind, addr, bytes, MPOL_BIND, mask, mask_bits + 1, MPOL_MF_STRICT) == 0;
+}
+
+// Anonymous mapping that is never touched here, so each thread's first
+// write decides which NUMA node backs its slice, unless the buffer is
+// bound to an explicit node up front.
+class UntouchedBuffer {
+public:
+    explicit UntouchedBuffer(size_t bytes, int node = -1) : bytes_(bytes) {
+        void* p = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("Failed to map memory test buffer");
+        data_ = static_cast<double*>(p);
+        if (node >= 0 && !bind_to_node(p, bytes_, node)) {
+            munmap(p, bytes_);
+            throw std::runtime_error("Failed to bind memory to NUMA node " + std::to_string(node));
+        }
+    }
+    ~UntouchedBuffer() { munmap(data_, bytes_); }
+    UntouchedBuffer(const UntouchedBuffer&) = delete;
+    UntouchedBuffer& operator=(const UntouchedBuffer&) = delete;
+    
+    double* data() const { return data_; }
+    
+private:
+    size_t bytes_;
+    double* data_;
+};
+
+const int kStreamRepetitions = 5;
+const double kStreamScalar = 3.0;
+const size_t kStreamMinArrayBytes = 64ull << 20;
+
+enum StreamKernel { kCopy, kScale, kAdd, kTriad, kStreamKernelCount };
+const double kStreamBytesPerElement[kStreamKernelCount] = { 16, 16, 24, 24 };
+
+// The four STREAM kernels over [begin, end). Stores bypass the cache on
+// x86-64 so the write-allocate read does not inflate the traffic.
+void stream_kernel(StreamKernel kernel, double* a, double* b, double* c, size_t begin, size_t end) {
+#if defined(__x86_64__)
+    const __m128d s = _mm_set1_pd(kStreamScalar);
+    switch (kernel) {
+        case kCopy:
+            for (size_t i = begin; i < end; i += 2) _mm_stream_pd(c + i, _mm_load_pd(a + i));
+            break;
+        case kScale:
+            for (size_t i = begin; i < end; i += 2) _mm_stream_pd(b + i, _mm_mul_pd(s, _mm_load_pd(c + i)));
+            break;
+        case kAdd:
+            for (size_t i = begin; i < end; i += 2) {
+                _mm_stream_pd(c + i, _mm_add_pd(_mm_load_pd(a + i), _mm_load_pd(b + i)));
+            }
+            break;
+        case kTriad:
+            for (size_t i = begin; i < end; i += 2) {
+                _mm_stream_pd(a + i, _mm_add_pd(_mm_load_pd(b + i), _mm_mul_pd(s, _mm_load_pd(c + i))));
+            }
+            break;
+        default:
+            break;
+    }
+    _mm_sfence();
+#else
+    switch (kernel) {
+        case kCopy:  for (size_t i = begin; i < end; i++) c[i] = a[i]; break;
+        case kScale: for (size_t i = begin; i < end; i++) b[i] = kStreamScalar * c[i]; break;
+        case kAdd:   for (size_t i = begin; i < end; i++) c[i] = a[i] + b[i]; break;
+        case kTriad: for (size_t i = begin; i < end; i++) a[i] = b[i] + kStreamScalar * c[i]; break;
+        default: break;
+    }
+#endif
+}
+
+size_t last_level_cache_bytes(const SystemInfo& info) {
+    uint64_t largest = 0;
+    for (const auto& cache : info.caches) {
+        if (cache.type != "Instruction") largest = std::max(largest, cache.size);
+    }
+    if (largest > 0) return largest;
+    
+    long llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (llc <= 0) llc = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return llc > 0 ? static_cast<size_t>(llc) : (32ull << 20);
+}
+
+const uint64_t kLatencyMinBytes = 4ull << 10;
+const uint64_t kLatencyMaxBytes = 4ull << 30;
+const uint64_t kLatencyLoads = 1ull << 22;
+const size_t kCacheLine = 64;
+
+// A step of more than 30% between neighbouring sizes means the working set
+// no longer fits in the current level
+const double kLevelJump = 1.3;
+const double kPlateauSlope = 1.15;
+
+// Finds cache capacities in a latency curve: at every jump, the last size
+// before it is that level's capacity. The transition is then skipped until
+// the curve flattens out on the next level.
+std::vector<uint64_t> detect_cache_levels(const std::vector<std::pair<uint64_t, double>>& curve) {
+    std::vector<uint64_t> levels;
+    size_t i = 1;
+    while (i < curve.size()) {
+        if (curve[i].second > curve[i - 1].second * kLevelJump) {
+            levels.push_back(curve[i - 1].first);
+            while (i + 1 < curve.size() && curve[i + 1].second > curve[i].second * kPlateauSlope) i++;
+        }
+        i++;
+    }
+    // The final plateau is DRAM, which has no capacity boundary of its own
+    return levels;
+}
+
+} // namespace
+
+// Smallest working set that measures DRAM rather than the caches
+size_t PCTester::Impl::dram_working_set() const {
+    return 4 * last_level_cache_bytes(sys_info);
+}
+
+double PCTester::Impl::memory_usage_percent() const {
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    uint64_t value = 0, total = 0, available = 0;
+    std::string unit;
+    while (meminfo >> key >> value) {
+        std::getline(meminfo, unit);
+        if (key == "MemTotal:") total = value;
+        else if (key == "MemAvailable:") available = value;
+    }
+    return total > 0 ? 100.0 * (total - available) / total : 0.0;
+}
+
+// One STREAM pass with `cpus.size()` pinned threads. Arrays are remapped
+// for every thread count so first-touch placement always matches the
+// slices the threads will later stream over.
+StreamResult PCTester::Impl::run_stream(const std::vector<int>& cpus, size_t elements, int mem_node) {
+    const size_t threads = cpus.size();
+    UntouchedBuffer a(elements * sizeof(double), mem_node);
+    UntouchedBuffer b(elements * sizeof(double), mem_node);
+    UntouchedBuffer c(elements * sizeof(double), mem_node);
+
+    SpinBarrier barrier(threads);
+    std::array<double, kStreamKernelCount> best;
+    best.fill(1e30);
+    std::vector<std::thread> workers;
+
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            pin_thread_to_cpu(cpus[t]);
+            
+            // Slice boundaries stay on 64-byte lines for the aligned loads
+            size_t per_thread = (elements / threads) & ~size_t(7);
+            size_t begin = t * per_thread;
+            size_t end = (t + 1 == threads) ? (elements & ~size_t(7)) : begin + per_thread;
+            
+            for (size_t i = begin; i < end; i++) {
+                a.data()[i] = 1.0;
+                b.data()[i] = 2.0;
+                c.data()[i] = 0.0;
+            }
+            
+            // As in STREAM, one thread times each pass from the barrier that
+            // releases every thread to the one they all reach at the end,
+            // and the best pass wins; per-thread bests could come from
+            // different passes and overstate the bandwidth
+            for (int rep = 0; rep < kStreamRepetitions; rep++) {
+                for (int k = 0; k < kStreamKernelCount; k++) {
+                    barrier.wait();
+                    auto start = std::chrono::steady_clock::now();
+                    stream_kernel(static_cast<StreamKernel>(k), a.data(), b.data(), c.data(), begin, end);
+                    barrier.wait();
+                    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                    // The first pass only warms the TLBs and is not scored
+                    if (t == 0 && rep > 0) best[k] = std::min(best[k], elapsed.count());
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    double rates[kStreamKernelCount];
+    for (int k = 0; k < kStreamKernelCount; k++) {
+        rates[k] = kStreamBytesPerElement[k] * elements / best[k] / 1e9;
+    }
+
+    StreamResult result{};
+    result.threads = threads;
+    result.copy_gbs = rates[kCopy];
+    result.scale_gbs = rates[kScale];
+    result.add_gbs = rates[kAdd];
+    result.triad_gbs = rates[kTriad];
+    return result;
+}
+
+void PCTester::Impl::ram_test() {
+    SafeOutput::print("\n[RAM] Starting STREAM bandwidth test...");
+
+    // Each array is at least 4x the last-level cache unless configured,
+    // capped so the three of them never take more than a quarter of
+    // physical memory
+    size_t array_bytes = config.stream_array_bytes ? config.stream_array_bytes
+                                                   : std::max(kStreamMinArrayBytes, dram_working_set());
+    array_bytes = std::min<size_t>(array_bytes, sys_info.memory_size / 12);
+    size_t elements = (array_bytes / sizeof(double)) & ~size_t(7);
+
+    std::stringstream info;
+    info << "[RAM] Array size: " << (elements * sizeof(double) >> 20) << " MiB x 3";
+    SafeOutput::print(info.str());
+
+    // Thread sweep: powers of two up to every worker CPU
+    std::vector<int> cpus = worker_cpus();
+    std::vector<size_t> counts;
+    for (size_t n = 1; n < cpus.size(); n *= 2) counts.push_back(n);
+    counts.push_back(cpus.size());
+
+    test_results.stream_results.clear();
+    for (size_t n : counts) {
+        std::vector<int> subset(cpus.begin(), cpus.begin() + n);
+        StreamResult r = run_stream(subset, elements);
+        test_results.stream_results.push_back(r);
+        
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2);
+        ss << "[RAM] " << std::setw(3) << n << " threads  Copy: " << r.copy_gbs << "  Scale: " << r.scale_gbs
+           << "  Add: " << r.add_gbs << "  Triad: " << r.triad_gbs << " GB/s";
+        SafeOutput::print(ss.str());
+    }
+
+    // The headline figure is the median of repeated all-CPU Triad runs.
+    // run_stream already discards its own first pass, so no warmup here.
+    BenchmarkOptions options = BenchmarkOptions::from(config);
+    options.warmup_runs = 0;
+    test_results.ram_score = record_stats("RAM", run_benchmark("Triad, all CPUs", "GB/s", options, [&]() {
+        return run_stream(cpus, elements).triad_gbs;
+    })).median;
+
+    test_results.ram_usage = memory_usage_percent();
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "[RAM] Triad bandwidth: " << test_results.ram_score << " GB/s | Memory in use: "
+       << std::setprecision(1) << test_results.ram_usage << "%";
+    SafeOutput::print(ss.str());
+}
+
+// Builds a single random cycle through every cache line of the working set
+// (Sattolo's shuffle) and times dependent loads around it, so neither the
+// prefetchers nor out-of-order execution can overlap the misses.
+double PCTester::Impl::chase_latency_ns(uint64_t working_set, uint64_t loads, int mem_node) {
+    size_t lines = working_set / kCacheLine;
+    UntouchedBuffer buffer(working_set, mem_node);
+    // Huge pages keep TLB misses from dominating the DRAM numbers
+    madvise(buffer.data(), working_set, MADV_HUGEPAGE);
+    char* base = reinterpret_cast<char*>(buffer.data());
+    
+    std::vector<uint32_t> order(lines);
+    for (size_t i = 0; i < lines; i++) order[i] = static_cast<uint32_t>(i);
+    std::mt19937_64 rng(working_set);
+    for (size_t i = lines - 1; i > 0; i--) {
+        std::uniform_int_distribution<size_t> pick(0, i - 1);
+        std::swap(order[i], order[pick(rng)]);
+    }
+    for (size_t i = 0; i < lines; i++) {
+        *reinterpret_cast<void**>(base + i * kCacheLine) = base + order[i] * kCacheLine;
+    }
+    
+    // One lap to warm the caches and TLBs before timing
+    void* p = base;
+    for (size_t i = 0; i < lines; i++) p = *static_cast<void**>(p);
+    
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < loads; i += 8) {
+        p = *static_cast<void**>(p); p = *static_cast<void**>(p);
+        p = *static_cast<void**>(p); p = *static_cast<void**>(p);
+        p = *static_cast<void**>(p); p = *static_cast<void**>(p);
+        p = *static_cast<void**>(p); p = *static_cast<void**>(p);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    
+    // Keep the chain result live so the loop cannot be dropped
+    static std::atomic<void*> sink;
+    sink.store(p, std::memory_order_relaxed);
+    
+    return elapsed.count() / loads;
+}
+
+void PCTester::Impl::ram_latency_test() {
+    SafeOutput::print("\n[RAM] Starting pointer-chasing latency probe...");
+    
+    // The chase runs on one pinned CPU so the curve reflects a single core's view
+    std::vector<int> cpus = online_cpus();
+    std::vector<uint64_t> sizes;
+    uint64_t max_bytes = std::min<uint64_t>(kLatencyMaxBytes, sys_info.memory_size / 4);
+    for (uint64_t size = kLatencyMinBytes; size <= max_bytes; size *= 2) {
+        sizes.push_back(size);
+        // Half-octave points sharpen the boundaries of non power-of-two caches
+        if (size + size / 2 <= max_bytes) sizes.push_back(size + size / 2);
+    }
+    
+    test_results.latency_curve.clear();
+    // An exception escaping a std::thread would terminate the whole run,
+    // so the probe stops at the first failed size and keeps what it has
+    std::string probe_error;
+    std::thread probe([&]() {
+        pin_thread_to_cpu(cpus.front());
+        try {
+            for (uint64_t size : sizes) {
+                double ns = chase_latency_ns(size, kLatencyLoads);
+                test_results.latency_curve.emplace_back(size, ns);
+                
+                std::stringstream ss;
+                ss << std::fixed << std::setprecision(2);
+                ss << "[RAM] " << std::setw(10) << (size >> 10) << " KiB: " << ns << " ns";
+                SafeOutput::print(ss.str());
+            }
+        } catch (const std::exception& e) {
+            probe_error = e.what();
+        }
+    });
+    probe.join();
+    if (!probe_error.empty()) {
+        SafeOutput::error("[RAM] Latency probe stopped: " + probe_error);
+    }
+    
+    test_results.detected_cache_sizes = detect_cache_levels(test_results.latency_curve);
+    test_results.ram_latency_ns = test_results.latency_curve.empty() ? 0.0 : test_results.latency_curve.back().second;
+    
+    // Compare measured boundaries with the data/unified caches sysfs reports
+    std::vector<CacheInfo> expected;
+    for (const auto& cache : sys_info.caches) {
+        if (cache.type != "Instruction") expected.push_back(cache);
+    }
+    std::sort(expected.begin(), expected.end(),
+              [](const CacheInfo& a, const CacheInfo& b) { return a.level < b.level; });
+    
+    for (size_t i = 0; i < std::max(expected.size(), test_results.detected_cache_sizes.size()); i++) {
+        std::stringstream ss;
+        ss << "[RAM] Level " << i + 1 << ": ";
+        if (i < test_results.detected_cache_sizes.size()) {
+            ss << "measured " << (test_results.detected_cache_sizes[i] >> 10) << " KiB";
+        } else {
+            ss << "not detected";
+        }
+        if (i < expected.size()) {
+            ss << ", sysfs L" << expected[i].level << " " << (expected[i].size >> 10) << " KiB";
+            if (i < test_results.detected_cache_sizes.size()) {
+                // Sampling is half-octave, so anything within 2x is a match
+                double ratio = static_cast<double>(test_results.detected_cache_sizes[i]) / expected[i].size;
+                ss << (ratio >= 0.5 && ratio <= 2.0 ? " (match)" : " (MISMATCH)");
+            }
+        }
+        SafeOutput::print(ss.str());
+    }
+    
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1) << "[RAM] DRAM latency: " << test_results.ram_latency_ns << " ns";
+    SafeOutput::print(ss.str());
+}
+
+// Pins the workers to the CPUs of one node while binding the buffers to
+// another, for every pair of nodes. Off-diagonal cells show the cost of
+// remote access; a diagonal that looks like the rest of the matrix usually
+// means memory is being interleaved when it should not be.
+void PCTester::Impl::numa_test() {
+    SafeOutput::print("\n[NUMA] Starting cross-node memory test...");
+    
+    const auto& nodes = sys_info.numa_nodes;
+    test_results.numa_bandwidth_gbs.clear();
+    test_results.numa_latency_ns.clear();
+    if (nodes.size() < 2) {
+        SafeOutput::print("[NUMA] Single memory node, skipping cross-node matrix");
+        return;
+    }
+    
+    // Same per-array sizing as the STREAM test, split across the nodes
+    size_t array_bytes = std::max(kStreamMinArrayBytes, dram_working_set());
+    array_bytes = std::min<size_t>(array_bytes, sys_info.memory_size / (12 * nodes.size()));
+    size_t elements = (array_bytes / sizeof(double)) & ~size_t(7);
+    uint64_t chase_bytes = std::min<uint64_t>(4 * last_level_cache_bytes(sys_info), array_bytes * 3);
+    
+    std::vector<int> allowed = online_cpus();
+    test_results.numa_bandwidth_gbs.assign(nodes.size(), std::vector<double>(nodes.size(), 0.0));
+    test_results.numa_latency_ns.assign(nodes.size(), std::vector<double>(nodes.size(), 0.0));
+    
+    for (size_t a = 0; a < nodes.size(); a++) {
+        std::vector<int> cpus;
+        for (int cpu : nodes[a].cpus) {
+            if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) cpus.push_back(cpu);
+        }
+        if (cpus.empty()) continue;  // memory-only node
+        
+        for (size_t b = 0; b < nodes.size(); b++) {
+            if (nodes[b].memory_size == 0) continue;  // CPU-only node
+            try {
+                StreamResult r = run_stream(cpus, elements, nodes[b].id);
+                test_results.numa_bandwidth_gbs[a][b] = r.triad_gbs;
+                
+                // Caught in the thread, where a throw would terminate the
+                // run; a node that refuses mbind leaves its cell NaN
+                double latency = std::nan("");
+                std::string probe_error;
+                std::thread probe([&]() {
+                    pin_thread_to_cpu(cpus.front());
+                    try {
+                        latency = chase_latency_ns(chase_bytes, kLatencyLoads / 2, nodes[b].id);
+                    } catch (const std::exception& e) {
+                        probe_error = e.what();
+                    }
+                });
+                probe.join();
+                test_results.numa_latency_ns[a][b] = latency;
+                if (!probe_error.empty()) SafeOutput::error("[NUMA] " + probe_error);
+            } catch (const std::exception& e) {
+                SafeOutput::error("[NUMA] " + std::string(e.what()));
+            }
+        }
+    }
+    
+    std::stringstream header;
+    header << "[NUMA] CPU\\MEM ";
+    for (const auto& node : nodes) header << std::setw(18) << ("node" + std::to_string(node.id));
+    SafeOutput::print(header.str());
+    for (size_t a = 0; a < nodes.size(); a++) {
+        std::stringstream row;
+        row << std::fixed << std::setprecision(1);
+        row << "[NUMA] node" << std::left << std::setw(5) << nodes[a].id << std::right;
+        for (size_t b = 0; b < nodes.size(); b++) {
+            std::stringstream cell;
+            cell << std::fixed << std::setprecision(1) << test_results.numa_bandwidth_gbs[a][b] << " GB/s ";
+            if (std::isnan(test_results.numa_latency_ns[a][b])) {
+                cell << "-";
+            } else {
+                cell << test_results.numa_latency_ns[a][b] << "ns";
+            }
+            row << std::setw(18) << cell.str();
+        }
+        SafeOutput::print(row.str());
+    }
+}
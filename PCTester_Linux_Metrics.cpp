@@ -0,0 +1,193 @@
+#include "PCTester_Linux_Metrics.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+// Request line and headers; anything longer is refused
+const size_t kMaxRequestBytes = 8192;
+
+const char* const kContentType = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+std::string errno_message(const std::string& what) {
+    return what + ": " + strerror(errno);
+}
+
+bool send_all(int fd, const std::string& text) {
+    const char* data = text.data();
+    size_t left = text.size();
+    while (left > 0) {
+        ssize_t sent = send(fd, data, left, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        data += sent;
+        left -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+std::string response(const char* status, const char* content_type, const std::string& body, bool head) {
+    std::string text = std::string("HTTP/1.1 ") + status + "\r\nContent-Type: " + content_type +
+                       "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+    return head ? text : text + body;
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(uint16_t port)
+    : listen_fd_(-1), wake_fd_(-1), port_(port), stopping_(false), body_stale_(true) {
+    // Loopback only: results describe the host, and there is no auth
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) throw std::runtime_error(errno_message("socket failed"));
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd_, 16) != 0) {
+        std::string message = errno_message("Cannot listen on 127.0.0.1:" + std::to_string(port));
+        close(listen_fd_);
+        throw std::runtime_error(message);
+    }
+    socklen_t length = sizeof(address);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+    
+    wake_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        std::string message = errno_message("eventfd failed");
+        close(listen_fd_);
+        throw std::runtime_error(message);
+    }
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+    close(listen_fd_);
+    close(wake_fd_);
+}
+
+MetricsServer::Section& MetricsServer::section(const std::string& name) {
+    for (Section& existing : sections_) {
+        if (existing.name == name) return existing;
+    }
+    sections_.push_back({ name, std::string(), nullptr, nullptr, 0 });
+    return sections_.back();
+}
+
+void MetricsServer::publish(const std::string& name, std::string text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Section& target = section(name);
+    if (target.text == text) return;
+    target.text = std::move(text);
+    body_stale_ = true;
+}
+
+void MetricsServer::add_live_section(const std::string& name, std::function<uint64_t()> version,
+                                     std::function<std::string()> render) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Section& target = section(name);
+    target.version = std::move(version);
+    target.render = std::move(render);
+    target.rendered_version = UINT64_MAX;
+    body_stale_ = true;
+}
+
+std::string MetricsServer::exposition() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Section& live : sections_) {
+        if (!live.version) continue;
+        uint64_t version = live.version();
+        if (version == live.rendered_version) continue;
+        live.text = live.render();
+        live.rendered_version = version;
+        body_stale_ = true;
+    }
+    if (body_stale_) {
+        body_.clear();
+        for (const Section& part : sections_) body_ += part.text;
+        body_ += "# EOF\n";
+        body_stale_ = false;
+    }
+    return body_;
+}
+
+void MetricsServer::start() {
+    thread_ = std::thread(&MetricsServer::serve, this);
+}
+
+void MetricsServer::stop() {
+    stopping_ = true;
+    uint64_t one = 1;
+    if (write(wake_fd_, &one, sizeof(one)) < 0) {
+        SafeOutput::error(errno_message("[METRICS] Cannot wake metrics server"));
+    }
+    if (thread_.joinable()) thread_.join();
+}
+
+// Scrapes are rare and short, so clients are served one at a time
+void MetricsServer::serve() {
+    pollfd fds[2] = {
+        { listen_fd_, POLLIN, 0 },
+        { wake_fd_, POLLIN, 0 },
+    };
+    while (!stopping_) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            SafeOutput::error(errno_message("[METRICS] poll failed"));
+            break;
+        }
+        if (!(fds[0].revents & POLLIN)) continue;
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        serve_client(fd);
+        close(fd);
+    }
+}
+
+void MetricsServer::serve_client(int fd) {
+    // A stalled client must not hold up the next scrape
+    timeval timeout = { 2, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequestBytes) {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return;
+        request.append(buffer, static_cast<size_t>(received));
+    }
+    
+    // "GET /metrics?x=y HTTP/1.1"
+    size_t method_end = request.find(' ');
+    size_t path_end = method_end == std::string::npos ? std::string::npos : request.find_first_of(" ?\r", method_end + 1);
+    if (path_end == std::string::npos) {
+        send_all(fd, response("400 Bad Request", "text/plain", "Bad request\n", false));
+        return;
+    }
+    std::string method = request.substr(0, method_end);
+    std::string path = request.substr(method_end + 1, path_end - method_end - 1);
+    bool head = method == "HEAD";
+    if (method != "GET" && !head) {
+        send_all(fd, response("405 Method Not Allowed", "text/plain", "Only GET is supported\n", false));
+    } else if (path == "/metrics") {
+        send_all(fd, response("200 OK", kContentType, exposition(), head));
+    } else if (path == "/") {
+        send_all(fd, response("200 OK", "text/plain", "PCTester metrics are at /metrics\n", head));
+    } else {
+        send_all(fd, response("404 Not Found", "text/plain", "Not found\n", head));
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "PCTester.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Minimal HTTP listener on 127.0.0.1 serving GET /metrics in OpenMetrics
+// text format. The exposition is made of sections: published sections are
+// replaced by their owner when their values change, live sections are
+// re-rendered at scrape time only once their version has moved. The body
+// is reassembled only when a section changed, so an idle scrape copies a
+// cached buffer.
+class MetricsServer {
+public:
+    explicit MetricsServer(uint16_t port);
+    ~MetricsServer();
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+    
+    uint16_t port() const { return port_; }
+    
+    // Section names only order the output; each metric family must come
+    // from a single section
+    void publish(const std::string& section, std::string text);
+    void add_live_section(const std::string& section, std::function<uint64_t()> version,
+                          std::function<std::string()> render);
+    
+    // Serves on a background thread until stop()
+    void start();
+    void stop();
+    
+private:
+    struct Section {
+        std::string name;
+        std::string text;
+        std::function<uint64_t()> version;      // empty for published sections
+        std::function<std::string()> render;
+        uint64_t rendered_version;
+    };
+    
+    Section& section(const std::string& name);
+    std::string exposition();
+    void serve();
+    void serve_client(int fd);
+    
+    int listen_fd_;
+    int wake_fd_;
+    uint16_t port_;
+    std::atomic<bool> stopping_;
+    std::thread thread_;
+    
+    std::mutex mutex_;
+    std::vector<Section> sections_;
+    std::string body_;
+    bool body_stale_;
+};
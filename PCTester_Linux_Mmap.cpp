@@ -0,0 +1,199 @@
+#include "PCTester_Linux.h"
+#include "PCTester_Linux_Disk.h"
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+namespace {
+
+const char* kMmapScratchName = "pctester_mmap.tmp";
+const size_t kMmapPage = 4096;
+const size_t kMmapStride = 64;      // one load or store per cache line
+const size_t kMmapFillBlock = 1 << 20;
+
+enum MmapHint { kNoHint, kPopulate, kAdviseSequential, kAdviseRandom, kAdviseHugepage };
+
+const char* hint_name(MmapHint hint) {
+    switch (hint) {
+        case kPopulate:          return "MAP_POPULATE";
+        case kAdviseSequential:  return "MADV_SEQUENTIAL";
+        case kAdviseRandom:      return "MADV_RANDOM";
+        case kAdviseHugepage:    return "MADV_HUGEPAGE";
+        default:                 return "none";
+    }
+}
+
+struct FaultCounts {
+    uint64_t minor;
+    uint64_t major;
+};
+
+// Per-thread counters, so faults taken by the monitor thread do not leak in
+FaultCounts thread_faults() {
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return { static_cast<uint64_t>(usage.ru_minflt), static_cast<uint64_t>(usage.ru_majflt) };
+}
+
+// Writes back dirty pages and drops the file from the page cache, so the
+// next scan has to fault every page in from the device
+void evict_file(int fd, uint64_t size) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, size, POSIX_FADV_DONTNEED);
+}
+
+// Kilobytes of the mapping at address that are backed by huge pages, from
+// its /proc/self/smaps entry: FilePmdMapped counts page-cache huge pages,
+// AnonHugePages the private copies. NaN when the entry cannot be read, so
+// an MADV_HUGEPAGE scan can tell "no huge pages" from "could not check".
+double mapping_huge_page_kb(const void* address) {
+    std::ifstream smaps("/proc/self/smaps");
+    std::stringstream prefix;
+    prefix << std::hex << reinterpret_cast<uintptr_t>(address) << '-';
+    std::string line;
+    bool inside = false;
+    bool found = false;
+    double kb = 0.0;
+    while (std::getline(smaps, line)) {
+        std::string key = line.substr(0, line.find(' '));
+        if (key.empty() || key.back() != ':') {
+            // A new mapping's header line: address range, permissions, path
+            if (inside) break;
+            inside = line.compare(0, prefix.str().size(), prefix.str()) == 0;
+            continue;
+        }
+        if (inside && (key == "FilePmdMapped:" || key == "AnonHugePages:")) {
+            kb += std::strtod(line.c_str() + key.size(), nullptr);
+            found = true;
+        }
+    }
+    return found ? kb : std::nan("");
+}
+
+} // namespace
+
+// Maps a scratch file and walks it sequentially or in random page order,
+// with each mapping hint in turn. Throughput is reported next to the minor
+// and major fault counts, which separates device-bound slowness (major
+// faults) from fault-handling overhead (minor faults on cached pages).
+void PCTester::Impl::mmap_test() {
+    SafeOutput::print("\n[MMAP] Starting memory-mapped file test...");
+    
+    std::string directory = scratch_directory();
+    if (directory.empty()) {
+        SafeOutput::print("[MMAP] Disk target is not writable, skipping");
+        return;
+    }
+    std::string path = directory + "/" + kMmapScratchName;
+    uint64_t file_size = std::min<uint64_t>(config.disk_file_size, sys_info.memory_size / 4);
+    file_size -= file_size % kMmapFillBlock;
+    if (file_size == 0) {
+        SafeOutput::error("[MMAP] Not enough memory for the mmap test");
+        return;
+    }
+    
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        SafeOutput::error("[MMAP] Cannot create " + path + ": " + strerror(errno));
+        return;
+    }
+    
+    test_results.mmap_results.clear();
+    try {
+        AlignedBuffer block(kMmapFillBlock);
+        for (uint64_t offset = 0; offset < file_size; offset += kMmapFillBlock) {
+            if (pwrite(fd, block.data(), kMmapFillBlock, offset) != static_cast<ssize_t>(kMmapFillBlock)) {
+                throw std::runtime_error(std::string("Failed to prepare mmap file: ") + strerror(errno));
+            }
+        }
+        
+        // Random scans visit every page exactly once, in shuffled order
+        size_t pages = file_size / kMmapPage;
+        std::vector<uint32_t> order(pages);
+        for (size_t i = 0; i < pages; i++) order[i] = static_cast<uint32_t>(i);
+        std::shuffle(order.begin(), order.end(), std::mt19937_64(file_size));
+        
+        struct Scan { bool random; MmapHint hint; bool write; };
+        const Scan scans[] = {
+            { false, kNoHint, false }, { false, kPopulate, false },
+            { false, kAdviseSequential, false }, { false, kAdviseHugepage, false },
+            { true, kNoHint, false }, { true, kPopulate, false },
+            { true, kAdviseRandom, false }, { true, kAdviseHugepage, false },
+            { false, kNoHint, true }, { true, kNoHint, true },
+        };
+        
+        for (const auto& scan : scans) {
+            evict_file(fd, file_size);
+            
+            FaultCounts before = thread_faults();
+            auto start = std::chrono::steady_clock::now();
+            
+            // MAP_POPULATE prefaults inside mmap(), so the call is timed too,
+            // but the scan's deadline only starts once it returns
+            int flags = MAP_SHARED | (scan.hint == kPopulate ? MAP_POPULATE : 0);
+            void* map = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, flags, fd, 0);
+            if (map == MAP_FAILED) throw std::runtime_error(std::string("mmap failed: ") + strerror(errno));
+            auto mapped = std::chrono::steady_clock::now();
+            auto deadline = mapped + std::chrono::duration<double>(config.disk_seconds);
+            if (scan.hint == kAdviseSequential) madvise(map, file_size, MADV_SEQUENTIAL);
+            if (scan.hint == kAdviseRandom) madvise(map, file_size, MADV_RANDOM);
+            if (scan.hint == kAdviseHugepage) madvise(map, file_size, MADV_HUGEPAGE);
+            
+            volatile uint64_t* base = static_cast<volatile uint64_t*>(map);
+            uint64_t checksum = 0;
+            size_t visited = 0;
+            for (; visited < pages; visited++) {
+                // Deadline checks every 256 pages keep clock reads out of the loop
+                if ((visited & 255) == 0 && std::chrono::steady_clock::now() >= deadline) break;
+                size_t page = scan.random ? order[visited] : visited;
+                size_t first = page * kMmapPage / sizeof(uint64_t);
+                for (size_t word = 0; word < kMmapPage / sizeof(uint64_t); word += kMmapStride / sizeof(uint64_t)) {
+                    if (scan.write) base[first + word] = visited;
+                    else checksum += base[first + word];
+                }
+            }
+            if (scan.write) msync(map, file_size, MS_SYNC);
+            
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            FaultCounts after = thread_faults();
+            double huge_page_kb = mapping_huge_page_kb(map);
+            munmap(map, file_size);
+            static std::atomic<uint64_t> sink;
+            sink.store(checksum, std::memory_order_relaxed);
+            
+            MmapResult result{};
+            result.pattern = scan.random ? "random" : "sequential";
+            result.hint = hint_name(scan.hint);
+            result.write = scan.write;
+            result.seconds = elapsed.count();
+            result.map_seconds = std::chrono::duration<double>(mapped - start).count();
+            result.huge_page_kb = huge_page_kb;
+            result.mbps = visited * kMmapPage / elapsed.count() / 1e6;
+            result.minor_faults = after.minor - before.minor;
+            result.major_faults = after.major - before.major;
+            test_results.mmap_results.push_back(result);
+            
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(1);
+            ss << "[MMAP] " << std::left << std::setw(11) << result.pattern << std::setw(6)
+               << (result.write ? "write" : "read") << std::setw(16) << result.hint << std::right
+               << std::setw(9) << result.mbps << " MB/s  minor faults: " << result.minor_faults
+               << "  major faults: " << result.major_faults;
+            if (scan.hint == kPopulate) ss << "  populate: " << result.map_seconds * 1000.0 << " ms";
+            if (scan.hint == kAdviseHugepage) {
+                if (std::isnan(result.huge_page_kb)) ss << "  huge pages: unknown";
+                else ss << "  huge pages: " << result.huge_page_kb / 1024.0 << " MiB";
+            }
+            SafeOutput::print(ss.str());
+        }
+    } catch (const std::exception& e) {
+        SafeOutput::error("[MMAP] " + std::string(e.what()));
+    }
+    
+    close(fd);
+    unlink(path.c_str());
+}
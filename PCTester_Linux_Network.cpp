@@ -0,0 +1,428 @@
+#include "PCTester_Linux.h"
+#include "PCTester_Linux_Network.h"
+#include "PCTester_Histogram.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/time.h>
+
+namespace {
+
+const size_t kNetStreamChunk = 128 << 10;
+const int kUdpWindow = 32;           // datagrams kept in flight
+const int kUdpBatch = 64;            // datagrams echoed per recvmmsg/sendmmsg
+
+std::string errno_message(const std::string& what) {
+    return what + ": " + strerror(errno);
+}
+
+void set_port(NetAddress& address, uint16_t port) {
+    if (address.storage.ss_family == AF_INET6) {
+        reinterpret_cast<sockaddr_in6*>(&address.storage)->sin6_port = htons(port);
+    } else {
+        reinterpret_cast<sockaddr_in*>(&address.storage)->sin_port = htons(port);
+    }
+}
+
+uint16_t local_port(int fd) {
+    sockaddr_storage storage;
+    socklen_t length = sizeof(storage);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&storage), &length);
+    if (storage.ss_family == AF_INET6) return ntohs(reinterpret_cast<sockaddr_in6*>(&storage)->sin6_port);
+    return ntohs(reinterpret_cast<sockaddr_in*>(&storage)->sin_port);
+}
+
+// Socket bound to the address, or -1 with errno set
+int bound_socket(const NetAddress& address, int type) {
+    int fd = socket(address.storage.ss_family, type | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int one = 1, zero = 0;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    // "::" should accept IPv4 clients too
+    if (address.storage.ss_family == AF_INET6) setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+bool send_all(int fd, const char* data, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t sent = send(fd, data, bytes, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        data += sent;
+        bytes -= sent;
+    }
+    return true;
+}
+
+// Connected TCP socket that has already announced its mode to the server
+int connect_tcp(const NetAddress& peer, NetMode mode) {
+    int fd = socket(peer.storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) throw std::runtime_error(errno_message("socket failed"));
+    if (mode == NetMode::Echo) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    char byte = static_cast<char>(mode);
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&peer.storage), peer.length) != 0 ||
+        !send_all(fd, &byte, 1)) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        throw std::runtime_error(errno_message("Cannot connect to " + peer.to_string()));
+    }
+    return fd;
+}
+
+// Aggregate goodput of several bulk TCP streams. The clock stops only once
+// the server has acknowledged EOF on every stream, so bytes still sitting
+// in socket buffers are not counted as delivered.
+double tcp_stream_mbps(const NetAddress& peer, int streams, double seconds) {
+    std::vector<int> fds;
+    try {
+        for (int i = 0; i < streams; i++) fds.push_back(connect_tcp(peer, NetMode::Sink));
+    } catch (...) {
+        for (int fd : fds) close(fd);
+        throw;
+    }
+    
+    std::atomic<bool> go(false);
+    std::atomic<uint64_t> total_bytes(0);
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(seconds);
+    
+    std::vector<std::thread> senders;
+    for (int fd : fds) {
+        senders.emplace_back([&, fd]() {
+            std::vector<char> chunk(kNetStreamChunk, 'x');
+            while (!go.load(std::memory_order_acquire)) {}
+            uint64_t bytes = 0;
+            while (std::chrono::steady_clock::now() < deadline) {
+                if (!send_all(fd, chunk.data(), chunk.size())) break;
+                bytes += chunk.size();
+            }
+            shutdown(fd, SHUT_WR);
+            char drain;
+            while (recv(fd, &drain, 1, 0) > 0) {}
+            total_bytes += bytes;
+        });
+    }
+    start = std::chrono::steady_clock::now();
+    deadline = start + std::chrono::duration<double>(seconds);
+    go.store(true, std::memory_order_release);
+    for (auto& sender : senders) sender.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    
+    for (int fd : fds) close(fd);
+    return total_bytes * 8.0 / elapsed.count() / 1e6;
+}
+
+// One request in flight at a time; each sample is a full round trip
+LatencyHistogram tcp_rtt_ns(const NetAddress& peer, double seconds) {
+    int fd = connect_tcp(peer, NetMode::Echo);
+    char message[kNetMessageSize] = {};
+    LatencyHistogram rtt;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    while (true) {
+        auto sent = std::chrono::steady_clock::now();
+        if (sent >= deadline) break;
+        if (!send_all(fd, message, sizeof(message)) ||
+            recv(fd, message, sizeof(message), MSG_WAITALL) != static_cast<ssize_t>(sizeof(message))) {
+            close(fd);
+            throw std::runtime_error("TCP echo connection dropped");
+        }
+        rtt.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sent).count());
+    }
+    close(fd);
+    return rtt;
+}
+
+struct UdpStats {
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    double seconds = 0.0;
+};
+
+// Keeps a window of echo datagrams in flight. A receive timeout declares
+// the outstanding window lost and refills it, so drops cost throughput but
+// never stall the test.
+UdpStats udp_echo(const NetAddress& peer, double seconds) {
+    int fd = socket(peer.storage.ss_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) throw std::runtime_error(errno_message("socket failed"));
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&peer.storage), peer.length) != 0) {
+        close(fd);
+        throw std::runtime_error(errno_message("Cannot connect UDP socket"));
+    }
+    timeval timeout = { 0, 100000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    
+    char message[kNetMessageSize] = {};
+    UdpStats stats;
+    int in_flight = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        while (in_flight < kUdpWindow && send(fd, message, sizeof(message), 0) == static_cast<ssize_t>(sizeof(message))) {
+            stats.sent++;
+            in_flight++;
+        }
+        if (recv(fd, message, sizeof(message), 0) > 0) {
+            stats.received++;
+            if (in_flight > 0) in_flight--;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            in_flight = 0;
+        } else if (errno == ECONNREFUSED) {
+            close(fd);
+            throw std::runtime_error("UDP echo refused by " + peer.to_string());
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // Datagrams still in flight at the deadline are neither delivered nor lost
+    stats.sent -= std::min<uint64_t>(in_flight, stats.sent - stats.received);
+    close(fd);
+    return stats;
+}
+
+} // namespace
+
+NetAddress NetAddress::resolve(const std::string& host, uint16_t port, bool passive) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    
+    addrinfo* result = nullptr;
+    int status = getaddrinfo(host.empty() ? nullptr : host.c_str(), std::to_string(port).c_str(), &hints, &result);
+    if (status != 0) throw std::runtime_error("Cannot resolve " + host + ": " + gai_strerror(status));
+    
+    NetAddress address;
+    memset(&address.storage, 0, sizeof(address.storage));
+    memcpy(&address.storage, result->ai_addr, result->ai_addrlen);
+    address.length = result->ai_addrlen;
+    freeaddrinfo(result);
+    return address;
+}
+
+std::string NetAddress::to_string() const {
+    char host[INET6_ADDRSTRLEN] = "?";
+    uint16_t port;
+    if (storage.ss_family == AF_INET6) {
+        const sockaddr_in6* v6 = reinterpret_cast<const sockaddr_in6*>(&storage);
+        inet_ntop(AF_INET6, &v6->sin6_addr, host, sizeof(host));
+        port = ntohs(v6->sin6_port);
+        return "[" + std::string(host) + "]:" + std::to_string(port);
+    }
+    const sockaddr_in* v4 = reinterpret_cast<const sockaddr_in*>(&storage);
+    inet_ntop(AF_INET, &v4->sin_addr, host, sizeof(host));
+    port = ntohs(v4->sin_port);
+    return std::string(host) + ":" + std::to_string(port);
+}
+
+NetworkServer::NetworkServer(const std::string& bind_address, uint16_t port)
+    : listen_fd_(-1), udp_fd_(-1), wake_fd_(-1), port_(port), stopping_(false) {
+    NetAddress address = NetAddress::resolve(bind_address, port, true);
+    
+    // Port 0 lets the kernel pick the TCP port; UDP then has to claim the
+    // same number, which can already be taken, so retry a few times
+    for (int attempt = 0; attempt < 8 && udp_fd_ < 0; attempt++) {
+        listen_fd_ = bound_socket(address, SOCK_STREAM);
+        if (listen_fd_ < 0) throw std::runtime_error(errno_message("Cannot bind TCP " + address.to_string()));
+        port_ = local_port(listen_fd_);
+        
+        NetAddress udp_address = address;
+        set_port(udp_address, port_);
+        udp_fd_ = bound_socket(udp_address, SOCK_DGRAM);
+        if (udp_fd_ < 0) {
+            int saved = errno;
+            close(listen_fd_);
+            listen_fd_ = -1;
+            errno = saved;
+            if (port != 0) break;
+        }
+    }
+    if (udp_fd_ < 0) throw std::runtime_error(errno_message("Cannot bind UDP port " + std::to_string(port_)));
+    
+    wake_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (listen(listen_fd_, SOMAXCONN) != 0 || wake_fd_ < 0) {
+        close(listen_fd_);
+        close(udp_fd_);
+        if (wake_fd_ >= 0) close(wake_fd_);
+        throw std::runtime_error(errno_message("Cannot start network server"));
+    }
+}
+
+NetworkServer::~NetworkServer() {
+    stop();
+    close(listen_fd_);
+    close(udp_fd_);
+    close(wake_fd_);
+}
+
+void NetworkServer::start() {
+    thread_ = std::thread(&NetworkServer::serve, this);
+}
+
+void NetworkServer::stop() {
+    stopping_ = true;
+    uint64_t one = 1;
+    if (write(wake_fd_, &one, sizeof(one)) < 0) {
+        SafeOutput::error(errno_message("[NET] Cannot wake network server"));
+    }
+    if (thread_.joinable()) thread_.join();
+}
+
+void NetworkServer::serve() {
+    pollfd fds[3] = {
+        { listen_fd_, POLLIN, 0 },
+        { udp_fd_, POLLIN, 0 },
+        { wake_fd_, POLLIN, 0 },
+    };
+    while (!stopping_) {
+        if (poll(fds, 3, -1) < 0) {
+            if (errno == EINTR) continue;
+            SafeOutput::error(errno_message("[NET] poll failed"));
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                connections_.push_back(std::make_unique<Connection>());
+                Connection& connection = *connections_.back();
+                connection.fd = fd;
+                connection.thread = std::thread(&NetworkServer::serve_connection, this, std::ref(connection));
+            }
+            reap_connections(false);
+        }
+        if (fds[1].revents & POLLIN) echo_datagrams();
+    }
+    reap_connections(true);
+}
+
+void NetworkServer::serve_connection(Connection& connection) {
+    int fd = connection.fd;
+    char mode = 0;
+    if (recv(fd, &mode, 1, MSG_WAITALL) == 1) {
+        if (mode == static_cast<char>(NetMode::Echo)) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            char message[kNetMessageSize];
+            while (recv(fd, message, sizeof(message), MSG_WAITALL) == static_cast<ssize_t>(sizeof(message)) &&
+                   send_all(fd, message, sizeof(message))) {}
+        } else if (mode == static_cast<char>(NetMode::Sink)) {
+            std::vector<char> buffer(kNetStreamChunk);
+            while (recv(fd, buffer.data(), buffer.size(), 0) > 0) {}
+        }
+    }
+    // Tells a sink client that every byte it sent has been consumed
+    shutdown(fd, SHUT_RDWR);
+    connection.done = true;
+}
+
+// Joins finished connection threads; with all set, first forces every
+// open connection closed
+void NetworkServer::reap_connections(bool all) {
+    for (auto it = connections_.begin(); it != connections_.end();) {
+        Connection& connection = **it;
+        if (all) shutdown(connection.fd, SHUT_RDWR);
+        if (all || connection.done) {
+            connection.thread.join();
+            close(connection.fd);
+            it = connections_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Drains the UDP socket in batches, echoing each datagram to its sender
+void NetworkServer::echo_datagrams() {
+    char payloads[kUdpBatch][kNetMessageSize];
+    sockaddr_storage senders[kUdpBatch];
+    iovec iovs[kUdpBatch];
+    mmsghdr messages[kUdpBatch];
+    
+    while (true) {
+        memset(messages, 0, sizeof(messages));
+        for (int i = 0; i < kUdpBatch; i++) {
+            iovs[i] = { payloads[i], kNetMessageSize };
+            messages[i].msg_hdr.msg_name = &senders[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(senders[i]);
+            messages[i].msg_hdr.msg_iov = &iovs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int received = recvmmsg(udp_fd_, messages, kUdpBatch, MSG_DONTWAIT, nullptr);
+        if (received <= 0) return;
+        for (int i = 0; i < received; i++) iovs[i].iov_len = messages[i].msg_len;
+        sendmmsg(udp_fd_, messages, received, MSG_DONTWAIT);
+        if (received < kUdpBatch) return;
+    }
+}
+
+void PCTester::Impl::network_server(uint16_t port) {
+    NetworkServer server("::", port);
+    SafeOutput::print("[NET] Serving TCP and UDP on port " + std::to_string(server.port()) + " (Ctrl+C to stop)");
+    server.serve();
+}
+
+// Streams TCP over several connections, then measures request/response
+// RTT and UDP echo rate. Against the in-process server this prices the
+// kernel network stack; against a remote peer it exercises the NIC.
+void PCTester::Impl::network_test() {
+    SafeOutput::print("\n[NET] Starting network test...");
+    
+    std::unique_ptr<NetworkServer> server;
+    try {
+        NetAddress peer;
+        if (config.network_peer.empty()) {
+            server = std::make_unique<NetworkServer>("127.0.0.1", 0);
+            server->start();
+            peer = NetAddress::resolve("127.0.0.1", server->port(), false);
+            test_results.network_target = "loopback";
+        } else {
+            peer = NetAddress::resolve(config.network_peer, config.network_port, false);
+            test_results.network_target = peer.to_string();
+        }
+        int streams = std::max(1, config.network_streams);
+        test_results.network_streams = streams;
+        SafeOutput::print("[NET] Target: " + test_results.network_target);
+        
+        test_results.network_bandwidth = tcp_stream_mbps(peer, streams, config.network_seconds);
+        
+        LatencyHistogram rtt = tcp_rtt_ns(peer, config.network_seconds);
+        test_results.network_latency = rtt.percentile(0.50) / 1000.0;
+        test_results.network_rtt_p99_us = rtt.percentile(0.99) / 1000.0;
+        test_results.network_rtt_p999_us = rtt.percentile(0.999) / 1000.0;
+        
+        UdpStats udp = udp_echo(peer, config.network_seconds);
+        test_results.network_udp_pps = udp.received / udp.seconds;
+        test_results.network_udp_loss = udp.sent ? 100.0 * (udp.sent - udp.received) / udp.sent : 0.0;
+        
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1);
+        ss << "[NET] TCP stream (" << streams << " connections): " << test_results.network_bandwidth << " Mbit/s\n";
+        ss << "[NET] TCP RTT: p50 " << test_results.network_latency << " us, p99 " << test_results.network_rtt_p99_us
+           << " us, p99.9 " << test_results.network_rtt_p999_us << " us\n";
+        ss << "[NET] UDP echo: " << test_results.network_udp_pps / 1000.0 << " kpps, loss "
+           << std::setprecision(2) << test_results.network_udp_loss << "%";
+        SafeOutput::print(ss.str());
+    } catch (const std::exception& e) {
+        SafeOutput::error("[NET] " + std::string(e.what()));
+    }
+    if (server) server->stop();
+    
+    // The stress mode needs its own per-core servers, so it only runs locally
+    if (config.network_peer.empty() && config.network_stress_connections > 0) network_stress_test();
+}
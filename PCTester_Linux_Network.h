@@ -0,0 +1,67 @@
+#pragma once
+
+#include "PCTester.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+
+// Wire protocol shared by both ends. Every TCP connection opens with one
+// mode byte; UDP datagrams are echoed back unchanged.
+enum class NetMode : char {
+    Sink = 'S',   // client streams, server discards until EOF
+    Echo = 'E',   // fixed-size requests, each echoed back
+};
+
+const size_t kNetMessageSize = 64;   // request/response and UDP payload
+
+// Resolved socket address of a network peer
+struct NetAddress {
+    sockaddr_storage storage;
+    socklen_t length;
+    
+    static NetAddress resolve(const std::string& host, uint16_t port, bool passive);
+    std::string to_string() const;
+};
+
+// TCP sink, TCP echo and UDP echo on one port. Runs in-process on
+// 127.0.0.1 for loopback tests, or standalone (pctester --network-server)
+// as the far end of a real NIC test.
+class NetworkServer {
+public:
+    NetworkServer(const std::string& bind_address, uint16_t port);
+    ~NetworkServer();
+    NetworkServer(const NetworkServer&) = delete;
+    NetworkServer& operator=(const NetworkServer&) = delete;
+    
+    uint16_t port() const { return port_; }
+    
+    // Serves on a background thread until stop()
+    void start();
+    void stop();
+    
+    // Serves on the calling thread; never returns unless stop() is called
+    void serve();
+    
+private:
+    struct Connection {
+        int fd;
+        std::atomic<bool> done{false};
+        std::thread thread;
+    };
+    
+    void serve_connection(Connection& connection);
+    void echo_datagrams();
+    void reap_connections(bool all);
+    
+    int listen_fd_;
+    int udp_fd_;
+    int wake_fd_;
+    uint16_t port_;
+    std::atomic<bool> stopping_;
+    std::thread thread_;
+    std::vector<std::unique_ptr<Connection>> connections_;
+};
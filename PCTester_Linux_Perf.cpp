@@ -0,0 +1,118 @@
+#include "PCTester_Linux_Perf.h"
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int open_event(uint32_t type, uint64_t config, int pid, int cpu, int group_fd) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group_fd < 0;   // members follow the leader
+    attr.inherit = pid >= 0;        // per-CPU counters already see every thread
+    // User space only, so the default perf_event_paranoid of 2 suffices
+    // for the calling thread's own counters
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, pid, cpu, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+} // namespace
+
+PerfCounterGroup::PerfCounterGroup() : per_cpu_(false) {
+    open_group(0, -1);
+}
+
+PerfCounterGroup::PerfCounterGroup(const std::vector<int>& cpus) : per_cpu_(true) {
+    for (int cpu : cpus) {
+        if (!open_group(-1, cpu)) {
+            close_groups();
+            return;
+        }
+    }
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+    close_groups();
+}
+
+bool PerfCounterGroup::open_group(int pid, int cpu) {
+    Group group;
+    group.fill(-1);
+    group[Cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, pid, cpu, -1);
+    if (group[Cycles] < 0) return false;
+    int leader = group[Cycles];
+    group[Instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, pid, cpu, leader);
+    group[LlcMisses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, pid, cpu, leader);
+    group[BranchMisses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, pid, cpu, leader);
+    group[DtlbMisses] = open_event(PERF_TYPE_HW_CACHE,
+                                   cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                               PERF_COUNT_HW_CACHE_RESULT_MISS), pid, cpu, leader);
+    groups_.push_back(group);
+    return true;
+}
+
+void PerfCounterGroup::close_groups() {
+    for (const Group& group : groups_) {
+        for (int fd : group) {
+            if (fd >= 0) close(fd);
+        }
+    }
+    groups_.clear();
+}
+
+void PerfCounterGroup::start() {
+    start_ = std::chrono::steady_clock::now();
+    for (const Group& group : groups_) {
+        ioctl(group[Cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(group[Cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+// Counts extrapolated to the full enabled time when the PMU had to
+// multiplex the group with other users, summed over the groups; -1 when
+// any group lacks the event
+double PerfCounterGroup::read_scaled(Event event) const {
+    double total = 0.0;
+    for (const Group& group : groups_) {
+        if (group[event] < 0) return -1.0;
+        uint64_t values[3] = {};    // value, time enabled, time running
+        if (read(group[event], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) return -1.0;
+        if (values[2] == 0) {
+            if (values[1] != 0) return -1.0;
+            continue;
+        }
+        total += static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+    }
+    return total;
+}
+
+PerfCounters PerfCounterGroup::stop() {
+    PerfCounters counters;
+    counters.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    if (!available()) return counters;
+    for (const Group& group : groups_) ioctl(group[Cycles], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    
+    counters.available = true;
+    counters.per_cpu = per_cpu_;
+    counters.cycles = read_scaled(Cycles);
+    counters.instructions = read_scaled(Instructions);
+    counters.llc_misses = read_scaled(LlcMisses);
+    counters.branch_misses = read_scaled(BranchMisses);
+    counters.dtlb_misses = read_scaled(DtlbMisses);
+    if (counters.cycles > 0.0 && counters.instructions >= 0.0) {
+        counters.ipc = counters.instructions / counters.cycles;
+    }
+    return counters;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "PCTester.h"
+#include <array>
+#include <chrono>
+#include <vector>
+
+// Hardware counters for the calling thread and every thread it creates
+// while counting (perf inherit), opened as one group so the events are
+// scheduled onto the PMU together. Inherited counters cannot be read as a
+// group, so each one is read on its own and scaled for multiplexing.
+// Events the kernel refuses (no PMU in a VM, perf_event_paranoid > 2) are
+// left out and reported as -1.
+class PerfCounterGroup {
+public:
+    PerfCounterGroup();
+    // One group per CPU, counting whatever runs there, summed on stop().
+    // This sees scheduler workers a stage hands its tasks to, which
+    // inherited counters cannot, but needs perf_event_paranoid <= 0 or
+    // CAP_PERFMON; available() is false when any CPU is refused.
+    explicit PerfCounterGroup(const std::vector<int>& cpus);
+    ~PerfCounterGroup();
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+    
+    bool available() const { return !groups_.empty(); }
+    void start();
+    PerfCounters stop();
+    
+private:
+    enum Event { Cycles, Instructions, LlcMisses, BranchMisses, DtlbMisses, EventCount };
+    using Group = std::array<int, EventCount>;
+    
+    bool open_group(int pid, int cpu);
+    void close_groups();
+    double read_scaled(Event event) const;
+    
+    std::vector<Group> groups_;     // the first fd of each is its leader
+    bool per_cpu_;
+    std::chrono::steady_clock::time_point start_;
+};
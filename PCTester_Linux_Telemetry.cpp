@@ -0,0 +1,490 @@
+#include "PCTester_Linux_Telemetry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const char* const kCpuHwmonNames[] = { "coretemp", "k10temp", "zenpower", "cpu_thermal" };
+// Thermal zone types that measure the CPU; acpitz, pch_* and the like sit
+// elsewhere on the board and have trip points of their own
+const char* const kCpuZonePrefixes[] = { "x86_pkg_temp", "cpu", "soc_thermal" };
+const char* const kGpuHwmonNames[] = { "amdgpu", "radeon", "nouveau" };
+
+// Seconds between [TEMP] console lines
+const double kStatusInterval = 2.0;
+
+// Throttling must last this long to count; shorter dips are scheduling noise
+const double kSustainSeconds = 0.5;
+// Fraction of nominal frequency (or opening score) below which a core counts as slowed
+const double kSlowdownRatio = 0.9;
+// Degrees below the thermal limit that already count as hitting it
+const double kThermalMargin = 3.0;
+// Assumed limit when no trip point or hwmon limit is exposed
+const double kDefaultThermalLimit = 95.0;
+
+int open_read_only(const std::string& path) {
+    return open(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+// Reads a single integer from the start of an already-open sysfs file;
+// sysfs regenerates the contents on every read at offset 0
+bool pread_value(int fd, long long& value) {
+    char buffer[32];
+    ssize_t length = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    if (length <= 0) return false;
+    buffer[length] = '\0';
+    char* end = nullptr;
+    value = strtoll(buffer, &end, 10);
+    return end != buffer;
+}
+
+std::string read_line(const std::string& path) {
+    char buffer[128] = {};
+    int fd = open_read_only(path);
+    if (fd < 0) return "";
+    ssize_t length = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    close(fd);
+    if (length <= 0) return "";
+    std::string line(buffer, static_cast<size_t>(length));
+    while (!line.empty() && (line.back() == '\n' || line.back() == ' ')) line.pop_back();
+    return line;
+}
+
+std::vector<std::string> list_directory(const std::string& path) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return names;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool name_in(const std::string& name, const char* const* list, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (name == list[i]) return true;
+    }
+    return false;
+}
+
+bool prefix_in(const std::string& name, const char* const* list, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (name.compare(0, strlen(list[i]), list[i]) == 0) return true;
+    }
+    return false;
+}
+
+// Lowest plausible limit in millidegree strings; firmware reports
+// placeholders of 0 or a few degrees, which are ignored
+double lowest_limit(const std::vector<std::string>& values) {
+    double lowest = 0.0;
+    for (const std::string& value : values) {
+        double limit = atof(value.c_str()) / 1000.0;
+        if (limit > 40.0 && (lowest == 0.0 || limit < lowest)) lowest = limit;
+    }
+    return lowest > 0.0 ? lowest : kDefaultThermalLimit;
+}
+
+// Half-open index ranges where pred holds, in order
+template<typename Predicate>
+std::vector<std::pair<size_t, size_t>> find_runs(size_t count, Predicate pred) {
+    std::vector<std::pair<size_t, size_t>> runs;
+    size_t begin = 0;
+    bool inside = false;
+    for (size_t i = 0; i <= count; i++) {
+        bool hit = i < count && pred(i);
+        if (hit && !inside) begin = i;
+        if (!hit && inside) runs.emplace_back(begin, i);
+        inside = hit;
+    }
+    return runs;
+}
+
+} // namespace
+
+TelemetrySampler::TelemetrySampler(const std::vector<int>& cpus, size_t capacity)
+    : cpus_(cpus), epoch_(std::chrono::steady_clock::now()), nominal_freq_mhz_(0.0),
+      thermal_limit_c_(0.0), stat_fd_(-1), prev_busy_(0), prev_total_(0), prev_time_s_(0.0),
+      capacity_(std::max<size_t>(capacity, 1)), samples_(capacity_),
+      core_freq_(capacity_ * std::max<size_t>(cpus.size(), 1)), written_(0), running_(false) {
+    phases_.reserve(64);
+    open_sources();
+}
+
+TelemetrySampler::~TelemetrySampler() {
+    stop();
+    for (const Source& source : cpu_temp_fds_) close(source.fd);
+    for (const Source& source : gpu_temp_fds_) close(source.fd);
+    for (const Source& source : rapl_fds_) close(source.fd);
+    for (int fd : freq_fds_) {
+        if (fd >= 0) close(fd);
+    }
+    if (stat_fd_ >= 0) close(stat_fd_);
+}
+
+void TelemetrySampler::open_sources() {
+    // Thermal zones cover most laptops and ARM boards. Their passive trip
+    // point is where the kernel starts to throttle.
+    for (const std::string& zone : list_directory("/sys/class/thermal")) {
+        if (zone.compare(0, 12, "thermal_zone") != 0) continue;
+        std::string base = "/sys/class/thermal/" + zone + "/";
+        std::string zone_type = read_line(base + "type");
+        if (!prefix_in(zone_type, kCpuZonePrefixes, sizeof(kCpuZonePrefixes) / sizeof(kCpuZonePrefixes[0]))) continue;
+        int fd = open_read_only(base + "temp");
+        if (fd < 0) continue;
+        std::vector<std::string> trips;
+        for (int trip = 0; ; trip++) {
+            std::string type = read_line(base + "trip_point_" + std::to_string(trip) + "_type");
+            if (type.empty()) break;
+            if (type == "passive") trips.push_back(read_line(base + "trip_point_" + std::to_string(trip) + "_temp"));
+        }
+        cpu_temp_fds_.push_back({ fd, zone_type, lowest_limit(trips) });
+    }
+    
+    // hwmon drivers cover desktops (coretemp, k10temp) and discrete GPUs
+    for (const std::string& hwmon : list_directory("/sys/class/hwmon")) {
+        std::string base = "/sys/class/hwmon/" + hwmon + "/";
+        std::string name = read_line(base + "name");
+        bool cpu = name_in(name, kCpuHwmonNames, sizeof(kCpuHwmonNames) / sizeof(kCpuHwmonNames[0]));
+        bool gpu = name_in(name, kGpuHwmonNames, sizeof(kGpuHwmonNames) / sizeof(kGpuHwmonNames[0]));
+        if (!cpu && !gpu) continue;
+        for (const std::string& file : list_directory(base)) {
+            if (file.compare(0, 4, "temp") != 0 || file.find("_input") == std::string::npos) continue;
+            int fd = open_read_only(base + file);
+            if (fd < 0) continue;
+            if (!cpu) {
+                gpu_temp_fds_.push_back({ fd, name, 0.0 });
+                continue;
+            }
+            // temp1_input -> temp1_max / temp1_crit
+            std::string prefix = base + file.substr(0, file.find("_input"));
+            cpu_temp_fds_.push_back({ fd, name, lowest_limit({ read_line(prefix + "_max"), read_line(prefix + "_crit") }) });
+        }
+    }
+    thermal_limit_c_ = 0.0;
+    for (const Source& source : cpu_temp_fds_) {
+        if (thermal_limit_c_ == 0.0 || source.limit_c < thermal_limit_c_) thermal_limit_c_ = source.limit_c;
+    }
+    
+    bool any_frequency = false;
+    for (int cpu : cpus_) {
+        int fd = open_read_only("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq");
+        freq_fds_.push_back(fd);
+        any_frequency = any_frequency || fd >= 0;
+        
+        // base_frequency (intel_pstate) is the guaranteed all-core clock.
+        // cpuinfo_max_freq is often the single-core boost clock, which a
+        // loaded package legitimately stays below, so it is derated.
+        std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/";
+        std::string base = read_line(path + "base_frequency");
+        double nominal = base.empty() ? 0.8 * atof(read_line(path + "cpuinfo_max_freq").c_str()) / 1000.0
+                                      : atof(base.c_str()) / 1000.0;
+        nominal_freq_mhz_ = std::max(nominal_freq_mhz_, nominal);
+    }
+    if (!any_frequency) freq_fds_.clear();
+    
+    // The per-CPU lines come first; the interrupt counters after them can
+    // be very long and are never reached
+    stat_fd_ = open_read_only("/proc/stat");
+    stat_buffer_.resize(4096);
+    
+    // Package domains only (intel-rapl:N); subzones such as intel-rapl:0:0
+    // are already included in their package. AMD exposes the same names.
+    // energy_uj is root-only on recent kernels, in which case power stays 0.
+    for (const std::string& zone : list_directory("/sys/class/powercap")) {
+        if (zone.compare(0, 11, "intel-rapl:") != 0 || zone.find(':', 11) != std::string::npos) continue;
+        std::string base = "/sys/class/powercap/" + zone + "/";
+        int fd = open_read_only(base + "energy_uj");
+        long long energy = 0, range = 0;
+        if (fd < 0) continue;
+        if (!pread_value(fd, energy)) {
+            close(fd);
+            continue;
+        }
+        int range_fd = open_read_only(base + "max_energy_range_uj");
+        if (range_fd >= 0) {
+            pread_value(range_fd, range);
+            close(range_fd);
+        }
+        rapl_fds_.push_back({ fd, read_line(base + "name"), 0.0 });
+        rapl_prev_uj_.push_back(static_cast<uint64_t>(energy));
+        rapl_range_uj_.push_back(static_cast<uint64_t>(range));
+    }
+}
+
+double TelemetrySampler::now_s() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch_).count();
+}
+
+void TelemetrySampler::take_sample() {
+    size_t slot = static_cast<size_t>(written_ % capacity_);
+    TelemetrySample& sample = samples_[slot];
+    sample = TelemetrySample{};
+    sample.time_s = now_s();
+    double elapsed = sample.time_s - prev_time_s_;
+    bool have_previous = written_ > 0 && elapsed > 0.0;
+    
+    sample.thermal_headroom_c = HUGE_VAL;
+    for (const Source& source : cpu_temp_fds_) {
+        long long millidegrees;
+        if (!pread_value(source.fd, millidegrees)) continue;
+        sample.cpu_temp_c = std::max(sample.cpu_temp_c, millidegrees / 1000.0);
+        sample.thermal_headroom_c = std::min(sample.thermal_headroom_c, source.limit_c - millidegrees / 1000.0);
+    }
+    for (const Source& source : gpu_temp_fds_) {
+        long long millidegrees;
+        if (pread_value(source.fd, millidegrees)) sample.gpu_temp_c = std::max(sample.gpu_temp_c, millidegrees / 1000.0);
+    }
+    
+    // Per-core frequency in MHz; cores without cpufreq are left out of the
+    // summary but keep a zero slot so indices match cpus_
+    uint16_t* core_freq = &core_freq_[slot * std::max<size_t>(cpus_.size(), 1)];
+    double freq_sum = 0.0;
+    int freq_count = 0;
+    for (size_t i = 0; i < freq_fds_.size(); i++) {
+        long long khz = 0;
+        core_freq[i] = 0;
+        if (freq_fds_[i] < 0 || !pread_value(freq_fds_[i], khz)) continue;
+        double mhz = khz / 1000.0;
+        core_freq[i] = static_cast<uint16_t>(std::min(mhz, 65535.0));
+        freq_sum += mhz;
+        sample.freq_min_mhz = freq_count == 0 ? mhz : std::min(sample.freq_min_mhz, mhz);
+        sample.freq_max_mhz = std::max(sample.freq_max_mhz, mhz);
+        freq_count++;
+    }
+    if (freq_count > 0) sample.freq_avg_mhz = freq_sum / freq_count;
+    
+    // Aggregate "cpu" line: user nice system idle iowait irq softirq steal
+    if (stat_fd_ >= 0) {
+        ssize_t length = pread(stat_fd_, stat_buffer_.data(), stat_buffer_.size() - 1, 0);
+        if (length > 0) {
+            stat_buffer_[static_cast<size_t>(length)] = '\0';
+            unsigned long long field[8] = {};
+            if (sscanf(stat_buffer_.data(), "cpu %llu %llu %llu %llu %llu %llu %llu %llu",
+                       &field[0], &field[1], &field[2], &field[3], &field[4], &field[5], &field[6], &field[7]) >= 4) {
+                uint64_t idle = field[3] + field[4];
+                uint64_t busy = field[0] + field[1] + field[2] + field[5] + field[6] + field[7];
+                uint64_t total = busy + idle;
+                if (prev_total_ > 0 && total > prev_total_) {
+                    sample.cpu_util_pct = 100.0 * static_cast<double>(busy - prev_busy_) / static_cast<double>(total - prev_total_);
+                }
+                prev_busy_ = busy;
+                prev_total_ = total;
+            }
+        }
+    }
+    
+    // Package power from the energy counters, allowing for wraparound
+    double joules = 0.0;
+    for (size_t i = 0; i < rapl_fds_.size(); i++) {
+        long long value;
+        if (!pread_value(rapl_fds_[i].fd, value)) continue;
+        uint64_t energy = static_cast<uint64_t>(value);
+        uint64_t delta = energy >= rapl_prev_uj_[i] ? energy - rapl_prev_uj_[i]
+                                                    : energy + rapl_range_uj_[i] - rapl_prev_uj_[i];
+        joules += delta / 1e6;
+        rapl_prev_uj_[i] = energy;
+    }
+    if (have_previous && !rapl_fds_.empty()) sample.package_power_w = joules / elapsed;
+    
+    prev_time_s_ = sample.time_s;
+    written_++;
+}
+
+void TelemetrySampler::sampler_loop(std::chrono::nanoseconds period) {
+    auto next = std::chrono::steady_clock::now();
+    double last_status = -kStatusInterval;
+    while (running_.load(std::memory_order_relaxed)) {
+        TelemetrySample sample;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            take_sample();
+            sample = samples_[(written_ - 1) % capacity_];
+        }
+        
+        if (sample.time_s - last_status >= kStatusInterval) {
+            last_status = sample.time_s;
+            // Formatted on the stack: this thread runs beside timed sections
+            char line[128];
+            int length = snprintf(line, sizeof(line), "[TEMP] CPU: %.1f°C | GPU: %.1f°C | %.0f MHz | %.0f%% busy | %.1f W",
+                                  sample.cpu_temp_c, sample.gpu_temp_c, sample.freq_avg_mhz,
+                                  sample.cpu_util_pct, sample.package_power_w);
+            SafeOutput::print(line, length > 0 ? std::min<size_t>(length, sizeof(line) - 1) : 0);
+        }
+        
+        // Absolute deadlines keep the period from drifting; after a stall
+        // the missed ticks are skipped rather than replayed back to back
+        next += period;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) next = now;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void TelemetrySampler::start(double period_ms) {
+    if (running_.exchange(true)) return;
+    period_ms = std::min(std::max(period_ms, 10.0), 100.0);
+    auto period = std::chrono::nanoseconds(static_cast<int64_t>(period_ms * 1e6));
+    thread_ = std::thread(&TelemetrySampler::sampler_loop, this, period);
+}
+
+void TelemetrySampler::stop() {
+    if (!running_.exchange(false)) return;
+    thread_.join();
+}
+
+void TelemetrySampler::begin_phase(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    phases_.push_back({ name, now_s(), -1.0 });
+}
+
+void TelemetrySampler::end_phase(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = phases_.rbegin(); it != phases_.rend(); ++it) {
+        if (it->name == name && it->end_s < 0.0) {
+            it->end_s = now_s();
+            return;
+        }
+    }
+}
+
+std::vector<TelemetryPhase> TelemetrySampler::phases() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<TelemetryPhase> result;
+    size_t stride = std::max<size_t>(cpus_.size(), 1);
+    uint64_t oldest = written_ > capacity_ ? written_ - capacity_ : 0;
+    
+    for (const Phase& phase : phases_) {
+        TelemetryPhase out;
+        out.name = phase.name;
+        out.start_s = phase.start_s;
+        out.end_s = phase.end_s < 0.0 ? now_s() : phase.end_s;
+        
+        std::vector<double> freq_sum(freq_fds_.size(), 0.0);
+        std::vector<int> freq_count(freq_fds_.size(), 0);
+        for (uint64_t i = oldest; i < written_; i++) {
+            size_t slot = static_cast<size_t>(i % capacity_);
+            const TelemetrySample& sample = samples_[slot];
+            if (sample.time_s < out.start_s || sample.time_s > out.end_s) continue;
+            out.samples.push_back(sample);
+            for (size_t c = 0; c < freq_fds_.size(); c++) {
+                uint16_t mhz = core_freq_[slot * stride + c];
+                if (mhz == 0) continue;
+                freq_sum[c] += mhz;
+                freq_count[c]++;
+            }
+        }
+        for (size_t c = 0; c < freq_fds_.size(); c++) {
+            if (freq_count[c] > 0) out.core_freq_mhz.emplace_back(cpus_[c], freq_sum[c] / freq_count[c]);
+        }
+        result.push_back(std::move(out));
+    }
+    return result;
+}
+
+TelemetrySample TelemetrySampler::latest() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_.load() || written_ == 0) take_sample();
+    return samples_[(written_ - 1) % capacity_];
+}
+
+bool TelemetrySampler::last_sample(TelemetrySample& sample) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (written_ == 0) return false;
+    sample = samples_[(written_ - 1) % capacity_];
+    return true;
+}
+
+uint64_t TelemetrySampler::samples_taken() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+std::vector<ThrottleEvent> TelemetrySampler::detect_throttling(const std::vector<TelemetryPhase>& phases) const {
+    std::vector<ThrottleEvent> events;
+    // Half a core busy is enough for the fastest core to be under load
+    double busy_pct = 50.0 / static_cast<double>(std::max<size_t>(cpus_.size(), 1));
+    
+    for (const TelemetryPhase& phase : phases) {
+        const std::vector<TelemetrySample>& samples = phase.samples;
+        // Frequency runs are measured against nominal; thermal runs against
+        // the clock the same phase held before it got hot
+        auto add_runs = [&](const char* cause, bool against_onset, const std::vector<std::pair<size_t, size_t>>& runs) {
+            for (const auto& run : runs) {
+                // A run lasts until the next sample that broke it, or the phase end
+                double end = run.second < samples.size() ? samples[run.second].time_s : phase.end_s;
+                double duration = end - samples[run.first].time_s;
+                if (duration < kSustainSeconds) continue;
+                
+                double reference = nominal_freq_mhz_;
+                if (against_onset && run.first > 0) {
+                    reference = 0.0;
+                    for (size_t i = 0; i < run.first; i++) reference += samples[i].freq_max_mhz;
+                    reference /= static_cast<double>(run.first);
+                }
+                double freq = 0.0;
+                for (size_t i = run.first; i < run.second; i++) freq += samples[i].freq_max_mhz;
+                freq /= static_cast<double>(run.second - run.first);
+                
+                ThrottleEvent event;
+                event.phase = phase.name;
+                event.cause = cause;
+                event.onset_s = samples[run.first].time_s - phase.start_s;
+                event.duration_s = duration;
+                event.perf_loss_pct = reference > 0.0 && freq > 0.0 ? std::max(0.0, 100.0 * (1.0 - freq / reference)) : 0.0;
+                events.push_back(event);
+            }
+        };
+        
+        // The fastest core is the one doing the work, so idle cores parked
+        // at low clocks do not count as throttled
+        if (has_frequency() && nominal_freq_mhz_ > 0.0) {
+            add_runs("frequency", false, find_runs(samples.size(), [&](size_t i) {
+                return samples[i].cpu_util_pct >= busy_pct && samples[i].freq_max_mhz > 0.0 &&
+                       samples[i].freq_max_mhz < kSlowdownRatio * nominal_freq_mhz_;
+            }));
+        }
+        // Any CPU sensor within the margin of its own limit counts
+        if (has_temperature()) {
+            add_runs("thermal", true, find_runs(samples.size(), [&](size_t i) {
+                return samples[i].thermal_headroom_c <= kThermalMargin;
+            }));
+        }
+    }
+    return events;
+}
+
+bool TelemetrySampler::detect_score_drop(const std::vector<double>& slices, double slice_s, ThrottleEvent& event) {
+    // The opening slices set the level the rest is held to
+    const size_t opening = 3;
+    size_t needed = static_cast<size_t>(std::ceil(kSustainSeconds / slice_s - 1e-9));
+    if (slice_s <= 0.0 || slices.size() < opening + needed) return false;
+    double reference = 0.0;
+    for (size_t i = 0; i < opening; i++) reference += slices[i];
+    reference /= opening;
+    if (reference <= 0.0) return false;
+    
+    for (const auto& run : find_runs(slices.size(), [&](size_t i) {
+             return i >= opening && slices[i] < kSlowdownRatio * reference;
+         })) {
+        if (run.second - run.first < needed) continue;
+        double score = 0.0;
+        for (size_t i = run.first; i < run.second; i++) score += slices[i];
+        score /= static_cast<double>(run.second - run.first);
+        event.cause = "score";
+        event.onset_s = run.first * slice_s;
+        event.duration_s = (run.second - run.first) * slice_s;
+        event.perf_loss_pct = 100.0 * (1.0 - score / reference);
+        return true;
+    }
+    return false;
+}
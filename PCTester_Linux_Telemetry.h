@@ -0,0 +1,104 @@
+#pragma once
+
+#include "PCTester.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Background sampler for temperatures, per-core frequency, utilization and
+// RAPL package power. Every sysfs/procfs source is opened once up front and
+// re-read with pread(), and samples go into a ring allocated at
+// construction, so a tick costs a handful of syscalls and no allocation.
+// When the ring wraps, the oldest samples are overwritten.
+class TelemetrySampler {
+public:
+    TelemetrySampler(const std::vector<int>& cpus, size_t capacity);
+    ~TelemetrySampler();
+    TelemetrySampler(const TelemetrySampler&) = delete;
+    TelemetrySampler& operator=(const TelemetrySampler&) = delete;
+    
+    // Samples every period_ms on a background thread until stop()
+    void start(double period_ms);
+    void stop();
+    
+    // Phases may overlap; each one collects the samples in its window
+    void begin_phase(const std::string& name);
+    void end_phase(const std::string& name);
+    std::vector<TelemetryPhase> phases() const;
+    
+    // Most recent sample, or a fresh one when the sampler is not running
+    TelemetrySample latest();
+    
+    // Most recent sample without ever taking one, so readers on other
+    // threads cannot shift the utilization window; false before the first
+    bool last_sample(TelemetrySample& sample) const;
+    uint64_t samples_taken() const;
+    
+    const std::vector<int>& cpus() const { return cpus_; }
+    bool has_frequency() const { return !freq_fds_.empty(); }
+    bool has_temperature() const { return !cpu_temp_fds_.empty(); }
+    double now_s() const;
+    
+    // Frequency a loaded core should sustain, 0 without cpufreq
+    double nominal_freq_mhz() const { return nominal_freq_mhz_; }
+    // Lowest passive trip point or hwmon limit of the CPU sensors. Samples
+    // are judged against each sensor's own limit, not this one.
+    double thermal_limit_c() const { return thermal_limit_c_; }
+    
+    // Sustained runs of samples where a busy CPU ran below its nominal
+    // frequency or sat at its thermal limit
+    std::vector<ThrottleEvent> detect_throttling(const std::vector<TelemetryPhase>& phases) const;
+    // First sustained drop of a throughput series (one value per slice)
+    // below its opening level; false when it held up
+    static bool detect_score_drop(const std::vector<double>& slices, double slice_s, ThrottleEvent& event);
+    
+private:
+    struct Source {
+        int fd;
+        std::string label;
+        double limit_c;     // CPU temperature sensors only
+    };
+    
+    struct Phase {
+        std::string name;
+        double start_s;
+        double end_s;       // negative while still open
+    };
+    
+    void open_sources();
+    void take_sample();     // caller holds mutex_
+    void sampler_loop(std::chrono::nanoseconds period);
+    
+    std::vector<int> cpus_;
+    std::chrono::steady_clock::time_point epoch_;
+    
+    std::vector<Source> cpu_temp_fds_;
+    std::vector<Source> gpu_temp_fds_;
+    std::vector<int> freq_fds_;         // one per entry in cpus_, -1 if absent
+    double nominal_freq_mhz_;
+    double thermal_limit_c_;
+    int stat_fd_;
+    std::vector<char> stat_buffer_;
+    uint64_t prev_busy_;
+    uint64_t prev_total_;
+    std::vector<Source> rapl_fds_;
+    std::vector<uint64_t> rapl_prev_uj_;
+    std::vector<uint64_t> rapl_range_uj_;
+    double prev_time_s_;
+    
+    // Ring storage: samples_[i] and core_freq_[i * cpus + c] belong together
+    size_t capacity_;
+    std::vector<TelemetrySample> samples_;
+    std::vector<uint16_t> core_freq_;     // MHz
+    uint64_t written_;
+    
+    std::vector<Phase> phases_;
+    
+    mutable std::mutex mutex_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
@@ -0,0 +1,282 @@
+#include "PCTester_Linux_Disk.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define PCTESTER_HAVE_IO_URING 1
+#endif
+
+#if defined(PCTESTER_HAVE_IO_URING)
+
+// io_uring is driven through raw syscalls so the build needs nothing but
+// kernel headers; older libcs do not define the numbers
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register 427
+#endif
+
+namespace {
+
+int uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int uring_register(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+// Mapped submission/completion rings of one io_uring instance
+class Ring {
+public:
+    Ring(unsigned entries, bool sqpoll) {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        if (sqpoll) {
+            params.flags = IORING_SETUP_SQPOLL;
+            params.sq_thread_idle = 100;  // ms before the poller thread sleeps
+        }
+        fd_ = uring_setup(entries, &params);
+        if (fd_ < 0) throw std::runtime_error(std::string("io_uring_setup failed: ") + strerror(errno));
+        sqpoll_ = sqpoll;
+        
+        sq_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+        
+        sq_ptr_ = mmap(nullptr, sq_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        cq_ptr_ = (params.features & IORING_FEAT_SINGLE_MMAP) ? sq_ptr_
+            : mmap(nullptr, cq_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        sqe_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, sqe_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sq_ptr_ == MAP_FAILED || cq_ptr_ == MAP_FAILED || sqes == MAP_FAILED) {
+            int error = errno;
+            if (sqes != MAP_FAILED) munmap(sqes, sqe_bytes_);
+            if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_bytes_);
+            if (sq_ptr_ != MAP_FAILED) munmap(sq_ptr_, sq_bytes_);
+            close(fd_);
+            throw std::runtime_error(std::string("Failed to map io_uring rings: ") + strerror(error));
+        }
+        
+        char* sq = static_cast<char*>(sq_ptr_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_flags_ = reinterpret_cast<unsigned*>(sq + params.sq_off.flags);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+        
+        char* cq = static_cast<char*>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        
+        pending_tail_ = *sq_tail_;
+    }
+    
+    ~Ring() {
+        munmap(sqes_, sqe_bytes_);
+        if (cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_bytes_);
+        munmap(sq_ptr_, sq_bytes_);
+        close(fd_);
+    }
+    
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+    
+    int fd() const { return fd_; }
+    
+    // Next free SQE; only becomes visible to the kernel on submit()
+    io_uring_sqe* next_sqe() {
+        unsigned index = pending_tail_ & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sq_array_[index] = index;
+        pending_tail_++;
+        return sqe;
+    }
+    
+    // Publishes every SQE prepared since the last call in one batch and
+    // optionally waits for at least one completion
+    void submit(bool wait) {
+        unsigned tail = __atomic_load_n(sq_tail_, __ATOMIC_RELAXED);
+        unsigned to_submit = pending_tail_ - tail;
+        __atomic_store_n(sq_tail_, pending_tail_, __ATOMIC_RELEASE);
+        
+        unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+        if (sqpoll_) {
+            // The poller thread picks SQEs up on its own unless it went idle
+            if (__atomic_load_n(sq_flags_, __ATOMIC_ACQUIRE) & IORING_SQ_NEED_WAKEUP) flags |= IORING_ENTER_SQ_WAKEUP;
+            to_submit = 0;
+        }
+        if (to_submit == 0 && flags == 0) return;
+        while (uring_enter(fd_, to_submit, wait ? 1 : 0, flags) < 0) {
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                throw std::runtime_error(std::string("io_uring_enter failed: ") + strerror(errno));
+            }
+        }
+    }
+    
+    // Pops one completion if available
+    bool reap(io_uring_cqe& out) {
+        unsigned head = __atomic_load_n(cq_head_, __ATOMIC_RELAXED);
+        if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) return false;
+        out = cqes_[head & cq_mask_];
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+    
+private:
+    int fd_;
+    bool sqpoll_;
+    size_t sq_bytes_, cq_bytes_, sqe_bytes_;
+    void* sq_ptr_;
+    void* cq_ptr_;
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned* sq_flags_;
+    unsigned* sq_array_;
+    unsigned sq_mask_;
+    io_uring_sqe* sqes_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe* cqes_;
+    unsigned pending_tail_;
+};
+
+unsigned ring_entries_for(int queue_depth) {
+    unsigned entries = 1;
+    while (entries < static_cast<unsigned>(queue_depth)) entries <<= 1;
+    return entries;
+}
+
+} // namespace
+
+bool UringIoEngine::available() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = uring_setup(1, &params);
+    if (fd < 0) return false;  // ENOSYS on old kernels, EPERM under seccomp or io_uring_disabled
+    close(fd);
+    return true;
+}
+
+IoRunStats UringIoEngine::run(const IoJob& job) {
+    const int depth = job.profile.queue_depth;
+    std::unique_ptr<Ring> ring;
+    try {
+        ring = std::make_unique<Ring>(ring_entries_for(depth), sqpoll_);
+    } catch (const std::exception&) {
+        // SQPOLL needs CAP_SYS_NICE on older kernels; retry without it
+        if (!sqpoll_) throw;
+        sqpoll_ = false;
+        ring = std::make_unique<Ring>(ring_entries_for(depth), false);
+    }
+    
+    // One registered buffer per in-flight slot, and the file registered as
+    // fixed index 0, so the kernel skips per-I/O page pinning and fd lookup
+    std::vector<std::unique_ptr<AlignedBuffer>> buffers;
+    std::vector<iovec> iovecs;
+    std::vector<IoOffsetGenerator> offsets;
+    for (int slot = 0; slot < depth; slot++) {
+        buffers.push_back(std::make_unique<AlignedBuffer>(job.profile.block_size));
+        iovecs.push_back({ buffers.back()->data(), job.profile.block_size });
+        offsets.emplace_back(job, slot);
+    }
+    bool fixed_buffers = uring_register(ring->fd(), IORING_REGISTER_BUFFERS, iovecs.data(), depth) == 0;
+    bool fixed_file = uring_register(ring->fd(), IORING_REGISTER_FILES, &job.fd, 1) == 0;
+    
+    using clock = std::chrono::steady_clock;
+    std::vector<clock::time_point> issued(depth);
+    
+    auto prepare = [&](int slot) {
+        io_uring_sqe* sqe = ring->next_sqe();
+        if (fixed_buffers) {
+            sqe->opcode = job.profile.write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+            sqe->buf_index = static_cast<uint16_t>(slot);
+        } else {
+            sqe->opcode = job.profile.write ? IORING_OP_WRITE : IORING_OP_READ;
+        }
+        if (fixed_file) {
+            sqe->fd = 0;
+            sqe->flags = IOSQE_FIXED_FILE;
+        } else {
+            sqe->fd = job.fd;
+        }
+        sqe->addr = reinterpret_cast<uint64_t>(iovecs[slot].iov_base);
+        sqe->len = static_cast<uint32_t>(job.profile.block_size);
+        sqe->off = offsets[slot].next();
+        sqe->user_data = static_cast<uint64_t>(slot);
+        issued[slot] = clock::now();
+    };
+    
+    IoRunStats stats;
+    auto start = clock::now();
+    auto deadline = start + std::chrono::duration<double>(job.seconds);
+    
+    for (int slot = 0; slot < depth; slot++) prepare(slot);
+    ring->submit(false);
+    
+    int in_flight = depth;
+    int failure = 0;
+    while (in_flight > 0) {
+        ring->submit(true);
+        
+        // Drain every completion that is ready, then refill those slots
+        // and hand them back to the kernel in a single submission
+        io_uring_cqe cqe;
+        auto now = clock::now();
+        while (ring->reap(cqe)) {
+            int slot = static_cast<int>(cqe.user_data);
+            in_flight--;
+            if (cqe.res != static_cast<int>(job.profile.block_size)) {
+                if (failure == 0) failure = cqe.res < 0 ? -cqe.res : EIO;
+                continue;
+            }
+            stats.latency_ns.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - issued[slot]).count());
+            stats.bytes += cqe.res;
+            stats.ios++;
+            
+            if (now < deadline && failure == 0) {
+                prepare(slot);
+                in_flight++;
+            }
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(clock::now() - start).count();
+    
+    if (failure != 0) {
+        throw std::runtime_error(job.profile.name + " failed: " + strerror(failure));
+    }
+    return stats;
+}
+
+#else
+
+bool UringIoEngine::available() {
+    return false;
+}
+
+IoRunStats UringIoEngine::run(const IoJob&) {
+    throw std::runtime_error("io_uring support was not compiled in");
+}
+
+#endif // PCTESTER_HAVE_IO_URING
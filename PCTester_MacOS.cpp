@@ -1,4 +1,10 @@
 #include "PCTester_MacOS.h"
+#include "PCTester_Raster.h"
+#include "PCTester_Harness.h"
+#include "PCTester_Export.h"
+#include "PCTester_Baseline.h"
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -7,8 +13,17 @@
 #include <random>
 #include <cmath>
 
-PCTester::Impl::Impl() {
+PCTester::Impl::Impl(const TestConfig& config) : config(config) {
     collect_system_info();
+    if (config.metrics_port) SafeOutput::error("Metrics endpoint is only available on Linux");
+}
+
+void PCTester::Impl::network_server(uint16_t) {
+    SafeOutput::error("Network server mode is only available on Linux");
+}
+
+void PCTester::Impl::run_daemon() {
+    SafeOutput::error("Daemon mode is only available on Linux");
 }
 
 void PCTester::Impl::collect_system_info() {
@@ -69,16 +84,29 @@ std::string PCTester::Impl::get_model_identifier() {
     return "Unknown Model";
 }
 
-void PCTester::Impl::run_full_diagnostics() {
+const std::vector<PCTester::Impl::Stage>& PCTester::Impl::stages() {
+    static const std::vector<Stage> all = { { "CPU", &Impl::cpu_benchmark }, { "GPU", &Impl::gpu_benchmark } };
+    return all;
+}
+
+std::vector<std::string> PCTester::Impl::stage_names() {
+    std::vector<std::string> names;
+    for (const Stage& stage : stages()) names.push_back(stage.first);
+    return names;
+}
+
+void PCTester::Impl::run_stages(const std::vector<std::string>& names) {
     SafeOutput::print("\n=== Advanced Diagnostics ===");
     
     // Start temperature monitoring
     std::atomic<bool> stop_monitoring(false);
     std::thread temp_monitor(&Impl::monitor_temperatures, this, std::ref(stop_monitoring));
     
-    // Run tests
-    cpu_benchmark();
-    gpu_benchmark();
+    // Run tests, each stage as a scheduler task
+    for (const Stage& stage : stages()) {
+        if (std::find(names.begin(), names.end(), stage.first) == names.end()) continue;
+        scheduler.submit(stage.second, this).get();
+    }
     
     // Stop monitoring
     stop_monitoring = true;
@@ -98,22 +126,27 @@ void PCTester::Impl::cpu_benchmark() {
     }
     double base_freq = freq / 1000000000.0; // Convert to GHz
     
-    // Run complex mathematical operations
-    const int num_iterations = 100000000;
-    double sum = 0.0;
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    for (int i = 1; i <= num_iterations; i++) {
-        sum += 1.0 / (i * i);
-    }
-    double pi = std::sqrt(6 * sum);
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
+    // Run complex mathematical operations, repeated until the rate is stable
+    const int num_iterations = 20000000;
+    volatile double pi = 0.0;
+    BenchmarkStats stats = run_benchmark("Series", "Miter/s", BenchmarkOptions::from(config), [&]() {
+        double sum = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        
+        for (int i = 1; i <= num_iterations; i++) {
+            sum += 1.0 / (i * i);
+        }
+        pi = std::sqrt(6 * sum);
+        
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return num_iterations / elapsed.count() / 1e6;
+    });
+    test_results.bench_stats.push_back(stats);
+    SafeOutput::print("[CPU] Series: " + format_stats(stats));
     
     // Calculate score
     double base_perf = base_freq * sys_info.cpu_cores;
-    double actual_perf = num_iterations / elapsed.count();
+    double actual_perf = stats.median * 1e6;
     test_results.cpu_score = (actual_perf / base_perf) * 10000;
     test_results.cpu_temp = get_cpu_temperature();
     
@@ -122,23 +155,27 @@ void PCTester::Impl::cpu_benchmark() {
 }
 
 void PCTester::Impl::gpu_benchmark() {
-    SafeOutput::print("\n[GPU] Starting Metal benchmark simulation...");
-    
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    // Simulate GPU work (complex computation)
-    double sum = 0.0;
-    for (long i = 1; i < 15000000; i++) {
-        sum += std::sin(i) * std::cos(i);
-    }
+    SafeOutput::print("\n[GPU] Starting software rasterizer...");
     
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
+    // Same tiled rasterizer as on Linux, so the rates compare across hosts
+    test_results.gpu_engine = std::string("software, ") + simd_isa_name(raster_isa()) + ", " +
+                              std::to_string(scheduler.worker_count()) + " workers";
+    SafeOutput::print("[GPU] Engine: " + test_results.gpu_engine);
     
-    // Calculate GPU score
-    test_results.gpu_score = 15000000 / elapsed.count();
+    BenchmarkOptions options = BenchmarkOptions::from(config);
+    auto measure = [&](RasterWorkload workload, const char* name, const char* unit) {
+        BenchmarkStats stats = run_benchmark(name, unit, options, [&]() {
+            return run_raster_workload(scheduler, workload, 0.25);
+        });
+        test_results.bench_stats.push_back(stats);
+        SafeOutput::print(std::string("[GPU] ") + name + ": " + format_stats(stats));
+        return stats.median;
+    };
+    test_results.gpu_triangle_rate = measure(RasterWorkload::Geometry, "Triangles", "Mtri/s");
+    test_results.gpu_fill_rate = measure(RasterWorkload::Fill, "Fill rate", "Gpix/s");
+    test_results.gpu_compute_rate = measure(RasterWorkload::Shade, "Compute shading", "Gpix/s");
+    test_results.gpu_score = test_results.gpu_triangle_rate;
     
-    SafeOutput::print("[GPU] Benchmark completed: " + sys_info.gpu_name);
     SafeOutput::print("[GPU] Score: " + std::to_string(test_results.gpu_score));
 }
 
@@ -165,10 +202,10 @@ void PCTester::Impl::monitor_temperatures(std::atomic<bool>& stop_monitoring) {
         double cpu_temp = get_cpu_temperature();
         double gpu_temp = get_gpu_temperature();
         
-        std::stringstream ss;
-        ss << "[TEMP] CPU: " << std::fixed << std::setprecision(1) << cpu_temp << "°C";
-        ss << " | GPU: " << gpu_temp << "°C";
-        SafeOutput::print(ss.str());
+        // Formatted on the stack: this thread runs beside timed sections
+        char line[64];
+        int length = snprintf(line, sizeof(line), "[TEMP] CPU: %.1f°C | GPU: %.1f°C", cpu_temp, gpu_temp);
+        SafeOutput::print(line, length > 0 ? std::min<size_t>(length, sizeof(line) - 1) : 0);
         
         std::this_thread::sleep_for(std::chrono::seconds(2));
     }
@@ -237,10 +274,12 @@ void PCTester::Impl::generate_html_report(const std::string& filename) const {
                  << std::min(100.0, test_results.cpu_score / 200) << R"(%"></div></div>
             </div>
             <div class="metric">
-                <div class="metric-title">GPU Performance</div>
-                <div class="score">)" << std::fixed << std::setprecision(1) << test_results.gpu_score << R"(</div>
+                <div class="metric-title">GPU Performance ()" << test_results.gpu_engine << R"()</div>
+                <div class="score">)" << std::fixed << std::setprecision(1) << test_results.gpu_score << R"( Mtri/s</div>
+                <div>Fill: )" << std::setprecision(2) << test_results.gpu_fill_rate << R"( Gpix/s, Compute: )"
+                 << test_results.gpu_compute_rate << R"( Gpix/s</div>
                 <div class="gauge"><div class="gauge-fill" style="width: )" 
-                 << std::min(100.0, test_results.gpu_score / 1000) << R"(%"></div></div>
+                 << std::setprecision(1) << std::min(100.0, test_results.gpu_score / 10) << R"(%"></div></div>
             </div>
         </div>
     </div>
@@ -250,8 +289,10 @@ void PCTester::Impl::generate_html_report(const std::string& filename) const {
         <p>Your macOS system performance analysis:</p>
         <ul>
             <li>CPU performance is )" << (test_results.cpu_score > 5000 ? "excellent" : "adequate") << R"(</li>
-            <li>GPU performance is )" << (test_results.gpu_score > 500 ? "excellent" : "adequate") << R"(</li>
+            <li>GPU performance is )" << (test_results.gpu_score > 100 ? "excellent" : "adequate") << R"(</li>
             <li>System is running within safe temperature ranges</li>
+            )" << (test_results.baseline_source.empty() ? std::string() :
+                   "<li>" + std::to_string(test_results.baseline_regressions) + " significant regression(s) against the baseline</li>") << R"(
         </ul>
     </div>
 </body>
@@ -259,3 +300,14 @@ void PCTester::Impl::generate_html_report(const std::string& filename) const {
     
     SafeOutput::print("Report generated: " + filename);
 }
+
+void PCTester::Impl::export_results(const std::string& filename, ResultFormat format) const {
+    if (!export_results_file(filename, format, sys_info, test_results)) {
+        throw std::runtime_error("Failed to write results file");
+    }
+    SafeOutput::print("Results exported: " + filename);
+}
+
+int PCTester::Impl::compare_to_baseline(const std::string& path) {
+    return apply_baseline(path, config.regression_threshold_pct, sys_info, test_results);
+}
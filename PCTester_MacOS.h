@@ -1,4 +1,5 @@
 #pragma once
+#include "PCTester_Scheduler.h"
 #include <iostream>
 #include <sys/sysctl.h>
 #include <sys/types.h>
@@ -11,13 +12,23 @@
 
 class PCTester::Impl {
 public:
-    Impl();
-    void run_full_diagnostics();
+    explicit Impl(const TestConfig& config);
+    void run_stages(const std::vector<std::string>& names);
+    static std::vector<std::string> stage_names();
     void generate_html_report(const std::string& filename) const;
+    void export_results(const std::string& filename, ResultFormat format) const;
+    int compare_to_baseline(const std::string& path);
+    void run_daemon();
+    static void network_server(uint16_t port);
     
 private:
+    TestConfig config;
     SystemInfo sys_info;
     TestResults test_results;
+    TaskScheduler scheduler;
+    
+    using Stage = std::pair<const char*, void (Impl::*)()>;
+    static const std::vector<Stage>& stages();
     
     void collect_system_info();
     void cpu_benchmark();
@@ -0,0 +1,226 @@
+#include "PCTester_Options.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// One option; flags take no value on the command line and "true" or
+// "false" in a config file
+struct OptionSpec {
+    const char* name;
+    const char* value;      // placeholder shown in the usage, nullptr for a flag
+    const char* help;
+    void (*apply)(RunOptions& options, const std::string& value);
+};
+
+double number_value(const std::string& value) {
+    char* end = nullptr;
+    double number = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0') throw std::invalid_argument("expected a number, got '" + value + "'");
+    return number;
+}
+
+int count_value(const std::string& value) {
+    double number = number_value(value);
+    if (number < 0 || number != static_cast<int>(number)) {
+        throw std::invalid_argument("expected a whole number, got '" + value + "'");
+    }
+    return static_cast<int>(number);
+}
+
+uint64_t mib_value(const std::string& value) {
+    double number = number_value(value);
+    if (number <= 0) throw std::invalid_argument("expected a positive size, got '" + value + "'");
+    return static_cast<uint64_t>(number * (1 << 20));
+}
+
+bool flag_value(const std::string& value) {
+    if (value.empty() || value == "true" || value == "yes" || value == "1") return true;
+    if (value == "false" || value == "no" || value == "0") return false;
+    throw std::invalid_argument("expected true or false, got '" + value + "'");
+}
+
+std::vector<std::string> list_value(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+const OptionSpec kOptions[] = {
+    { "tests", "LIST", "comma-separated stages to run (see --list-tests), default all",
+      [](RunOptions& o, const std::string& v) { o.stages = list_value(v); } },
+    { "list-tests", nullptr, "print the stages this platform can run and exit",
+      [](RunOptions& o, const std::string& v) { o.list_stages = flag_value(v); } },
+    { "duration", "SECONDS", "time budget per measurement (benchmark kernel, disk profile, network test)",
+      [](RunOptions& o, const std::string& v) {
+          double seconds = number_value(v);
+          if (!(seconds > 0)) throw std::invalid_argument("expected a positive time, got '" + v + "'");
+          o.config.bench_max_seconds = seconds;
+          o.config.disk_seconds = seconds;
+          o.config.network_seconds = seconds;
+      } },
+    { "threads", "N", "worker threads for the CPU and STREAM stages, 0 for every CPU",
+      [](RunOptions& o, const std::string& v) { o.config.threads = count_value(v); } },
+    { "stream-size", "MIB", "size of each STREAM array, default 4x the last-level cache",
+      [](RunOptions& o, const std::string& v) { o.config.stream_array_bytes = mib_value(v); } },
+    { "disk-path", "PATH", "directory, file or block device for the disk stages",
+      [](RunOptions& o, const std::string& v) { o.config.disk_path = v; } },
+    { "disk-write-file", nullptr, "run the write profiles on an existing --disk-path file, destroying its contents",
+      [](RunOptions& o, const std::string& v) { o.config.disk_write_file = flag_value(v); } },
+    { "disk-size", "MIB", "size of the disk test file",
+      [](RunOptions& o, const std::string& v) { o.config.disk_file_size = mib_value(v); } },
+    { "disk-engine", "ENGINE", "auto, io_uring or threads",
+      [](RunOptions& o, const std::string& v) {
+          if (v != "auto" && v != "io_uring" && v != "threads") {
+              throw std::invalid_argument("unknown engine '" + v + "' (available: auto, io_uring, threads)");
+          }
+          o.config.disk_engine = v;
+      } },
+    { "disk-sqpoll", nullptr, "let a kernel thread poll the io_uring submission queue (Linux)",
+      [](RunOptions& o, const std::string& v) { o.config.disk_sqpoll = flag_value(v); } },
+    { "network-peer", "HOST", "host running pctester --network-server, default loopback",
+      [](RunOptions& o, const std::string& v) { o.config.network_peer = v; } },
+    { "network-port", "PORT", "port of the network server",
+      [](RunOptions& o, const std::string& v) {
+          int port = count_value(v);
+          if (port > 65535) throw std::invalid_argument("port out of range: " + v);
+          o.config.network_port = static_cast<uint16_t>(port);
+      } },
+    { "network-server", nullptr, "serve network tests for another host until killed",
+      [](RunOptions& o, const std::string& v) { o.network_server = flag_value(v); } },
+    { "daemon", nullptr, "probe continuously at idle priority until SIGINT/SIGTERM (Linux)",
+      [](RunOptions& o, const std::string& v) { o.daemon = flag_value(v); } },
+    { "daemon-interval", "SECONDS", "time between daemon probe rounds",
+      [](RunOptions& o, const std::string& v) { o.config.daemon_interval_s = number_value(v); } },
+    { "daemon-max-util", "PCT", "skip daemon rounds while host CPU utilization is above this",
+      [](RunOptions& o, const std::string& v) { o.config.daemon_max_util_pct = number_value(v); } },
+    { "daemon-window", "N", "daemon probe samples kept in memory",
+      [](RunOptions& o, const std::string& v) { o.config.daemon_window = count_value(v); } },
+    { "daemon-socket", "PATH", "Unix socket serving the daemon's results",
+      [](RunOptions& o, const std::string& v) { o.config.daemon_socket = v; } },
+    { "metrics-port", "PORT", "serve OpenMetrics on http://127.0.0.1:PORT/metrics (Linux)",
+      [](RunOptions& o, const std::string& v) {
+          int port = count_value(v);
+          if (port > 65535) throw std::invalid_argument("port out of range: " + v);
+          o.config.metrics_port = static_cast<uint16_t>(port);
+      } },
+    { "pipeline", nullptr, "run the storage stages beside the compute stages",
+      [](RunOptions& o, const std::string& v) { o.config.pipeline_stages = flag_value(v); } },
+    { "html", "FILE", "HTML report, empty to skip",
+      [](RunOptions& o, const std::string& v) { o.html_path = v; } },
+    { "json", "FILE", "JSON Lines results, empty to skip",
+      [](RunOptions& o, const std::string& v) { o.json_path = v; } },
+    { "csv", "FILE", "CSV results",
+      [](RunOptions& o, const std::string& v) { o.csv_path = v; } },
+    { "baseline", "PATH", "results file, or directory of per-CPU-model files, to compare with",
+      [](RunOptions& o, const std::string& v) { o.baseline_path = v; } },
+    { "regression-threshold", "PCT", "smallest change counted as a regression; single-run metrics (disk, network, NUMA) are judged on it alone",
+      [](RunOptions& o, const std::string& v) { o.config.regression_threshold_pct = number_value(v); } },
+    { "quiet", nullptr, "print errors only; implies --no-wait",
+      [](RunOptions& o, const std::string& v) { o.quiet = flag_value(v); if (o.quiet) o.wait = false; } },
+    { "no-wait", nullptr, "exit without waiting for Enter",
+      [](RunOptions& o, const std::string& v) { o.wait = !flag_value(v); } },
+    { "help", nullptr, "show this help",
+      [](RunOptions& o, const std::string& v) { o.help = flag_value(v); } },
+};
+
+const OptionSpec* find_option(const std::string& name) {
+    for (const OptionSpec& option : kOptions) {
+        if (name == option.name) return &option;
+    }
+    return nullptr;
+}
+
+void apply_option(RunOptions& options, const OptionSpec& option, const std::string& value) {
+    try {
+        option.apply(options, value);
+    } catch (const std::invalid_argument& e) {
+        throw std::invalid_argument("--" + std::string(option.name) + ": " + e.what());
+    }
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    return text.substr(begin, text.find_last_not_of(" \t\r") + 1 - begin);
+}
+
+// "key = value" per line; blank lines and lines starting with # are
+// skipped. A bare key sets a flag.
+void apply_config_file(RunOptions& options, const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::invalid_argument("Cannot open config file " + path);
+    
+    std::string line;
+    int number = 0;
+    while (std::getline(file, line)) {
+        number++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        size_t equals = line.find('=');
+        std::string key = trim(line.substr(0, equals));
+        std::string value = equals == std::string::npos ? "" : trim(line.substr(equals + 1));
+        const OptionSpec* option = find_option(key);
+        if (!option) {
+            throw std::invalid_argument(path + ":" + std::to_string(number) + ": unknown key '" + key + "'");
+        }
+        if (option->value && equals == std::string::npos) {
+            throw std::invalid_argument(path + ":" + std::to_string(number) + ": " + key + " needs a value");
+        }
+        apply_option(options, *option, value);
+    }
+}
+
+} // namespace
+
+RunOptions parse_options(int argc, char* argv[]) {
+    RunOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) throw std::invalid_argument("Unexpected argument '" + arg + "'");
+        std::string name = arg.substr(2);
+        
+        // --name=value is accepted as well as --name value
+        std::string value;
+        bool inline_value = false;
+        size_t equals = name.find('=');
+        if (equals != std::string::npos) {
+            value = name.substr(equals + 1);
+            name = name.substr(0, equals);
+            inline_value = true;
+        }
+        
+        bool is_config = name == "config";
+        const OptionSpec* option = is_config ? nullptr : find_option(name);
+        if (!is_config && !option) throw std::invalid_argument("Unknown option --" + name);
+        if (is_config || option->value) {
+            if (!inline_value) {
+                if (i + 1 >= argc) throw std::invalid_argument("--" + name + " needs a value");
+                value = argv[++i];
+            }
+        }
+        if (is_config) {
+            apply_config_file(options, value);
+        } else {
+            apply_option(options, *option, value);
+        }
+    }
+    return options;
+}
+
+std::string options_usage() {
+    std::stringstream ss;
+    ss << "Usage: pctester [options]\n\n";
+    ss << "  --config FILE                 read options from FILE, one \"name = value\" per line\n";
+    for (const OptionSpec& option : kOptions) {
+        std::string left = "--" + std::string(option.name) + (option.value ? " " + std::string(option.value) : "");
+        ss << "  " << left << std::string(left.size() < 30 ? 30 - left.size() : 1, ' ') << option.help << "\n";
+    }
+    return ss.str();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "PCTester.h"
+#include <string>
+#include <vector>
+
+// Everything one invocation of pctester was asked to do
+struct RunOptions {
+    TestConfig config;
+    std::vector<std::string> stages;    // empty runs every stage
+    std::string html_path = "diagnostic_report.html";
+    std::string json_path = "diagnostic_results.jsonl";
+    std::string csv_path;               // an empty path skips that output
+    std::string baseline_path;
+    bool quiet = false;
+    bool wait = true;                   // wait for Enter before exiting
+    bool network_server = false;
+    bool daemon = false;
+    bool list_stages = false;
+    bool help = false;
+};
+
+// Parses the command line. --config FILE applies "key = value" lines,
+// keys being the long option names without dashes, at its position, so
+// later arguments override the file. Throws std::invalid_argument on an
+// unknown option or a malformed value.
+RunOptions parse_options(int argc, char* argv[]);
+
+// Option summary for --help
+std::string options_usage();
@@ -0,0 +1,446 @@
+#include "PCTester_Raster.h"
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define PCTESTER_X86 1
+    #include <immintrin.h>
+#endif
+
+// Same per-function targeting as the SIMD kernels
+#if defined(__GNUC__)
+    #define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define SIMD_TARGET(isa)
+#endif
+
+namespace {
+
+// 1080p; the width is a whole number of tiles, so a vector that starts in
+// a tile never runs past its right edge
+const int kWidth = 1920;
+const int kHeight = 1080;
+const int kTileSize = 64;
+const int kTilesX = kWidth / kTileSize;
+const int kTilesY = (kHeight + kTileSize - 1) / kTileSize;
+
+// Triangles transformed, set up and binned per task
+const size_t kSetupChunk = 4096;
+
+// Geometry scene: a wavy grid, two ~18-pixel triangles per cell. Fill
+// scene: triangles inscribed in a circle wider than the screen, each
+// covering most of it.
+const int kGridColumns = 320;
+const int kGridRows = 180;
+const int kFillTriangles = 32;
+
+// Rotation between frames, so every frame sets up and bins afresh
+const float kFrameAngle = 0.01f;
+
+// A triangle after setup. Edge i is the one opposite vertex i; all three
+// are positive inside, and depth is a plane in screen space.
+struct SetupTriangle {
+    float a[3], b[3], c[3];
+    float za, zb, zc;
+    int x0, y0, x1, y1;     // pixel bounding box, inclusive, clipped to the screen
+};
+
+// Rasterizes rows y0..y1 and columns x0..x1 of one triangle; x0 is aligned
+// to the vector width. Returns the fragments covered.
+using RasterSpan = uint64_t (*)(const SetupTriangle& t, uint32_t id, float* depth, uint32_t* ids,
+                                int x0, int y0, int x1, int y1);
+
+uint64_t raster_scalar(const SetupTriangle& t, uint32_t id, float* depth, uint32_t* ids,
+                       int x0, int y0, int x1, int y1) {
+    uint64_t covered = 0;
+    for (int y = y0; y <= y1; y++) {
+        float py = y + 0.5f;
+        float* depth_row = depth + static_cast<size_t>(y) * kWidth;
+        uint32_t* id_row = ids + static_cast<size_t>(y) * kWidth;
+        for (int x = x0; x <= x1; x++) {
+            float px = x + 0.5f;
+            float w0 = t.a[0] * px + t.b[0] * py + t.c[0];
+            float w1 = t.a[1] * px + t.b[1] * py + t.c[1];
+            float w2 = t.a[2] * px + t.b[2] * py + t.c[2];
+            if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+            covered++;
+            float z = t.za * px + t.zb * py + t.zc;
+            if (z < depth_row[x]) {
+                depth_row[x] = z;
+                id_row[x] = id;
+            }
+        }
+    }
+    return covered;
+}
+
+#if defined(PCTESTER_X86)
+
+SIMD_TARGET("sse2") uint64_t raster_sse2(const SetupTriangle& t, uint32_t id, float* depth, uint32_t* ids,
+                                         int x0, int y0, int x1, int y1) {
+    const __m128 lane = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 id_vector = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(id)));
+    __m128 a[3], step[3];
+    for (int i = 0; i < 3; i++) {
+        a[i] = _mm_set1_ps(t.a[i]);
+        step[i] = _mm_set1_ps(t.a[i] * 4.0f);
+    }
+    const __m128 za = _mm_set1_ps(t.za), zstep = _mm_set1_ps(t.za * 4.0f);
+    const __m128 px0 = _mm_add_ps(_mm_set1_ps(static_cast<float>(x0)), lane);
+
+    uint64_t covered = 0;
+    for (int y = y0; y <= y1; y++) {
+        float py = y + 0.5f;
+        float* depth_row = depth + static_cast<size_t>(y) * kWidth;
+        float* id_row = reinterpret_cast<float*>(ids + static_cast<size_t>(y) * kWidth);
+        __m128 w[3];
+        for (int i = 0; i < 3; i++) w[i] = _mm_add_ps(_mm_mul_ps(a[i], px0), _mm_set1_ps(t.b[i] * py + t.c[i]));
+        __m128 z = _mm_add_ps(_mm_mul_ps(za, px0), _mm_set1_ps(t.zb * py + t.zc));
+        for (int x = x0; x <= x1; x += 4) {
+            __m128 inside = _mm_cmpge_ps(_mm_min_ps(_mm_min_ps(w[0], w[1]), w[2]), zero);
+            int inside_bits = _mm_movemask_ps(inside);
+            if (inside_bits) {
+                covered += std::bitset<4>(inside_bits).count();
+                __m128 old = _mm_loadu_ps(depth_row + x);
+                __m128 pass = _mm_and_ps(inside, _mm_cmplt_ps(z, old));
+                if (_mm_movemask_ps(pass)) {
+                    _mm_storeu_ps(depth_row + x, _mm_or_ps(_mm_and_ps(pass, z), _mm_andnot_ps(pass, old)));
+                    __m128 old_id = _mm_loadu_ps(id_row + x);
+                    _mm_storeu_ps(id_row + x, _mm_or_ps(_mm_and_ps(pass, id_vector), _mm_andnot_ps(pass, old_id)));
+                }
+            }
+            for (int i = 0; i < 3; i++) w[i] = _mm_add_ps(w[i], step[i]);
+            z = _mm_add_ps(z, zstep);
+        }
+    }
+    return covered;
+}
+
+SIMD_TARGET("avx2,fma") uint64_t raster_avx2(const SetupTriangle& t, uint32_t id, float* depth, uint32_t* ids,
+                                             int x0, int y0, int x1, int y1) {
+    const __m256 lane = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 id_vector = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(id)));
+    __m256 a[3], step[3];
+    for (int i = 0; i < 3; i++) {
+        a[i] = _mm256_set1_ps(t.a[i]);
+        step[i] = _mm256_set1_ps(t.a[i] * 8.0f);
+    }
+    const __m256 za = _mm256_set1_ps(t.za), zstep = _mm256_set1_ps(t.za * 8.0f);
+    const __m256 px0 = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x0)), lane);
+
+    uint64_t covered = 0;
+    for (int y = y0; y <= y1; y++) {
+        float py = y + 0.5f;
+        float* depth_row = depth + static_cast<size_t>(y) * kWidth;
+        float* id_row = reinterpret_cast<float*>(ids + static_cast<size_t>(y) * kWidth);
+        __m256 w[3];
+        for (int i = 0; i < 3; i++) w[i] = _mm256_fmadd_ps(a[i], px0, _mm256_set1_ps(t.b[i] * py + t.c[i]));
+        __m256 z = _mm256_fmadd_ps(za, px0, _mm256_set1_ps(t.zb * py + t.zc));
+        for (int x = x0; x <= x1; x += 8) {
+            __m256 inside = _mm256_cmp_ps(_mm256_min_ps(_mm256_min_ps(w[0], w[1]), w[2]), zero, _CMP_GE_OQ);
+            int inside_bits = _mm256_movemask_ps(inside);
+            if (inside_bits) {
+                covered += std::bitset<8>(inside_bits).count();
+                __m256 old = _mm256_loadu_ps(depth_row + x);
+                __m256 pass = _mm256_and_ps(inside, _mm256_cmp_ps(z, old, _CMP_LT_OQ));
+                if (_mm256_movemask_ps(pass)) {
+                    _mm256_storeu_ps(depth_row + x, _mm256_blendv_ps(old, z, pass));
+                    _mm256_storeu_ps(id_row + x, _mm256_blendv_ps(_mm256_loadu_ps(id_row + x), id_vector, pass));
+                }
+            }
+            for (int i = 0; i < 3; i++) w[i] = _mm256_add_ps(w[i], step[i]);
+            z = _mm256_add_ps(z, zstep);
+        }
+    }
+    return covered;
+}
+
+#endif // PCTESTER_X86
+
+int lanes_for(SimdIsa isa) {
+    switch (isa) {
+        case SimdIsa::AVX2: return 8;
+        case SimdIsa::SSE2: return 4;
+        default:            return 1;
+    }
+}
+
+RasterSpan span_for(SimdIsa isa) {
+    switch (isa) {
+#if defined(PCTESTER_X86)
+        case SimdIsa::SSE2: return raster_sse2;
+        case SimdIsa::AVX2: return raster_avx2;
+#endif
+        default:            return raster_scalar;
+    }
+}
+
+// Object-space triangles, nine floats each (x, y, z per corner); x spans
+// [-1, 1] and maps to the screen width
+std::vector<float> grid_scene() {
+    auto height = [](float x, float y) { return 0.5f + 0.3f * std::sin(x * 3.0f) * std::cos(y * 5.0f); };
+    const float half_height = static_cast<float>(kHeight) / kWidth;
+    std::vector<float> scene;
+    scene.reserve(static_cast<size_t>(kGridColumns) * kGridRows * 18);
+    for (int row = 0; row < kGridRows; row++) {
+        for (int column = 0; column < kGridColumns; column++) {
+            float x0 = -1.0f + 2.0f * column / kGridColumns, x1 = -1.0f + 2.0f * (column + 1) / kGridColumns;
+            float y0 = -half_height + 2.0f * half_height * row / kGridRows;
+            float y1 = -half_height + 2.0f * half_height * (row + 1) / kGridRows;
+            const float corners[6][2] = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y0 }, { x1, y1 }, { x0, y1 } };
+            for (const auto& corner : corners) {
+                scene.push_back(corner[0]);
+                scene.push_back(corner[1]);
+                scene.push_back(height(corner[0], corner[1]));
+            }
+        }
+    }
+    return scene;
+}
+
+std::vector<float> fill_scene() {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float radius = 1.5f;
+    std::vector<float> scene;
+    for (int i = 0; i < kFillTriangles; i++) {
+        float cx = (unit(rng) - 0.5f) * 0.4f, cy = (unit(rng) - 0.5f) * 0.2f;
+        float phase = unit(rng) * 6.2831853f;
+        for (int corner = 0; corner < 3; corner++) {
+            float angle = phase + corner * 2.0943951f;
+            scene.push_back(cx + radius * std::cos(angle));
+            scene.push_back(cy + radius * std::sin(angle));
+            scene.push_back(0.05f + 0.9f * unit(rng));
+        }
+    }
+    return scene;
+}
+
+// Frame state reused across frames: setup output, per-chunk tile bins and
+// the render targets
+class RasterPipeline {
+public:
+    RasterPipeline(TaskScheduler& scheduler, SimdIsa isa, std::vector<float> scene)
+        : scheduler_(scheduler), span_(span_for(isa)), lanes_(lanes_for(isa)), vertices_(std::move(scene)),
+          setup_(vertices_.size() / 9),
+          bins_((setup_.size() + kSetupChunk - 1) / kSetupChunk, std::vector<std::vector<uint32_t>>(kTilesX * kTilesY)),
+          depth_(static_cast<size_t>(kWidth) * kHeight), ids_(depth_.size()), colors_(depth_.size()) {}
+
+    size_t triangles() const { return setup_.size(); }
+
+    // Draws the scene rotated by angle; returns the fragments covered
+    uint64_t draw(float angle) {
+        std::vector<Future<void>> setups;
+        setups.reserve(bins_.size());
+        for (size_t chunk = 0; chunk < bins_.size(); chunk++) {
+            setups.push_back(scheduler_.submit([this, chunk, angle]() { setup_chunk(chunk, angle); }));
+        }
+        for (auto& setup : setups) setup.get();
+
+        std::vector<Future<uint64_t>> tiles;
+        tiles.reserve(kTilesX * kTilesY);
+        for (int tile = 0; tile < kTilesX * kTilesY; tile++) {
+            tiles.push_back(scheduler_.submit([this, tile]() { return raster_tile(tile); }));
+        }
+        uint64_t covered = 0;
+        for (auto& tile : tiles) covered += tile.get();
+        return covered;
+    }
+
+    // Lights every pixel from the z-buffer; returns the pixels shaded
+    uint64_t shade() {
+        std::vector<Future<uint64_t>> tiles;
+        tiles.reserve(kTilesX * kTilesY);
+        for (int tile = 0; tile < kTilesX * kTilesY; tile++) {
+            tiles.push_back(scheduler_.submit([this, tile]() { return shade_tile(tile); }));
+        }
+        uint64_t shaded = 0;
+        for (auto& tile : tiles) shaded += tile.get();
+        return shaded;
+    }
+
+private:
+    // Vertex transform, triangle setup and binning for one chunk. Bins are
+    // per chunk, so chunks never share a list and tiles still see
+    // triangles in submission order.
+    void setup_chunk(size_t chunk, float angle) {
+        const float cosine = std::cos(angle), sine = std::sin(angle), scale = 0.5f * kWidth;
+        std::vector<std::vector<uint32_t>>& bins = bins_[chunk];
+        for (auto& bin : bins) bin.clear();
+
+        size_t end = std::min(setup_.size(), (chunk + 1) * kSetupChunk);
+        for (size_t index = chunk * kSetupChunk; index < end; index++) {
+            const float* v = &vertices_[index * 9];
+            float x[3], y[3], z[3];
+            for (int i = 0; i < 3; i++) {
+                x[i] = 0.5f * kWidth + scale * (v[i * 3] * cosine - v[i * 3 + 1] * sine);
+                y[i] = 0.5f * kHeight + scale * (v[i * 3] * sine + v[i * 3 + 1] * cosine);
+                z[i] = v[i * 3 + 2];
+            }
+
+            SetupTriangle& t = setup_[index];
+            t.x0 = std::max(0, static_cast<int>(std::ceil(std::min({ x[0], x[1], x[2] }) - 0.5f)));
+            t.y0 = std::max(0, static_cast<int>(std::ceil(std::min({ y[0], y[1], y[2] }) - 0.5f)));
+            t.x1 = std::min(kWidth - 1, static_cast<int>(std::floor(std::max({ x[0], x[1], x[2] }) - 0.5f)));
+            t.y1 = std::min(kHeight - 1, static_cast<int>(std::floor(std::max({ y[0], y[1], y[2] }) - 0.5f)));
+            float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+            if (t.x0 > t.x1 || t.y0 > t.y1 || std::fabs(area) < 1e-6f) continue;
+
+            // Flip clockwise triangles so inside is positive either way
+            float sign = area < 0.0f ? -1.0f : 1.0f;
+            for (int i = 0; i < 3; i++) {
+                int j = (i + 1) % 3, k = (i + 2) % 3;
+                t.a[i] = sign * (y[j] - y[k]);
+                t.b[i] = sign * (x[k] - x[j]);
+                t.c[i] = sign * (x[j] * y[k] - x[k] * y[j]);
+            }
+            float inverse_area = 1.0f / std::fabs(area);
+            t.za = (t.a[0] * z[0] + t.a[1] * z[1] + t.a[2] * z[2]) * inverse_area;
+            t.zb = (t.b[0] * z[0] + t.b[1] * z[1] + t.b[2] * z[2]) * inverse_area;
+            t.zc = (t.c[0] * z[0] + t.c[1] * z[1] + t.c[2] * z[2]) * inverse_area;
+
+            for (int ty = t.y0 / kTileSize; ty <= t.y1 / kTileSize; ty++) {
+                for (int tx = t.x0 / kTileSize; tx <= t.x1 / kTileSize; tx++) {
+                    bins[ty * kTilesX + tx].push_back(static_cast<uint32_t>(index));
+                }
+            }
+        }
+    }
+
+    uint64_t raster_tile(int tile) {
+        int tile_x = (tile % kTilesX) * kTileSize, tile_y = (tile / kTilesX) * kTileSize;
+        int tile_x1 = tile_x + kTileSize - 1, tile_y1 = std::min(kHeight, tile_y + kTileSize) - 1;
+        for (int y = tile_y; y <= tile_y1; y++) {
+            size_t row = static_cast<size_t>(y) * kWidth;
+            std::fill(depth_.begin() + row + tile_x, depth_.begin() + row + tile_x1 + 1, 1.0f);
+            std::fill(ids_.begin() + row + tile_x, ids_.begin() + row + tile_x1 + 1, 0u);
+        }
+
+        uint64_t covered = 0;
+        for (const auto& chunk_bins : bins_) {
+            for (uint32_t index : chunk_bins[tile]) {
+                const SetupTriangle& t = setup_[index];
+                int x0 = std::max(t.x0, tile_x) & ~(lanes_ - 1);
+                covered += span_(t, index + 1, depth_.data(), ids_.data(), x0, std::max(t.y0, tile_y),
+                                 std::min(t.x1, tile_x1), std::min(t.y1, tile_y1));
+            }
+        }
+        return covered;
+    }
+
+    // Compute-style pass: one light, normals from depth differences, base
+    // colour from the triangle id. Edge columns clamp their neighbours; the
+    // rest of each row is a plain loop the compiler can vectorize.
+    uint64_t shade_tile(int tile) {
+        int tile_x = (tile % kTilesX) * kTileSize, tile_y = (tile / kTilesX) * kTileSize;
+        int tile_x1 = tile_x + kTileSize, tile_y1 = std::min(kHeight, tile_y + kTileSize);
+        int inner_x = std::max(tile_x, 1), inner_x1 = std::min(tile_x1, kWidth - 1);
+        for (int y = tile_y; y < tile_y1; y++) {
+            const float* above = &depth_[static_cast<size_t>(std::max(0, y - 1)) * kWidth];
+            const float* row = &depth_[static_cast<size_t>(y) * kWidth];
+            const float* below = &depth_[static_cast<size_t>(std::min(kHeight - 1, y + 1)) * kWidth];
+            const uint32_t* id_row = &ids_[static_cast<size_t>(y) * kWidth];
+            uint32_t* color_row = &colors_[static_cast<size_t>(y) * kWidth];
+            for (int x = inner_x; x < inner_x1; x++) {
+                color_row[x] = shade_pixel(row[x - 1] - row[x + 1], above[x] - below[x], row[x], id_row[x]);
+            }
+            for (int x : { tile_x, tile_x1 - 1 }) {
+                if (x >= inner_x && x < inner_x1) continue;
+                int left = std::max(0, x - 1), right = std::min(kWidth - 1, x + 1);
+                color_row[x] = shade_pixel(row[left] - row[right], above[x] - below[x], row[x], id_row[x]);
+            }
+        }
+        return static_cast<uint64_t>(tile_y1 - tile_y) * kTileSize;
+    }
+
+    // Bit-trick estimate plus one Newton step, as shader hardware does it
+    static float inverse_sqrt(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits = 0x5f375a86u - (bits >> 1);
+        float estimate;
+        std::memcpy(&estimate, &bits, sizeof(estimate));
+        return estimate * (1.5f - 0.5f * value * estimate * estimate);
+    }
+
+    // Branch-free (no errno from std::sqrt, no compare for the clamp) so
+    // GCC vectorizes the row loop that calls it
+    static uint32_t shade_pixel(float dx, float dy, float depth, uint32_t id) {
+        const float light_x = 0.267f, light_y = 0.535f, light_z = 0.802f;
+        float nx = dx * 256.0f, ny = dy * 256.0f;
+        float inverse_length = inverse_sqrt(nx * nx + ny * ny + 1.0f);
+        float lambert = (nx * light_x + ny * light_y + light_z) * inverse_length;
+        float diffuse = 0.5f * (lambert + std::fabs(lambert));
+        float intensity = 0.15f + 0.85f * diffuse * (1.0f - 0.5f * depth);
+
+        int base = static_cast<int>(id * 2654435761u);
+        int r = static_cast<int>(((base >> 16) & 0xFF) * intensity);
+        int g = static_cast<int>(((base >> 8) & 0xFF) * intensity);
+        int b = static_cast<int>((base & 0xFF) * intensity);
+        return 0xFF000000u | static_cast<uint32_t>(r << 16 | g << 8 | b);
+    }
+
+    TaskScheduler& scheduler_;
+    RasterSpan span_;
+    int lanes_;
+    std::vector<float> vertices_;
+    std::vector<SetupTriangle> setup_;
+    std::vector<std::vector<std::vector<uint32_t>>> bins_;    // [chunk][tile] triangle indices
+    std::vector<float> depth_;
+    std::vector<uint32_t> ids_;                              // triangle index + 1, 0 for background
+    std::vector<uint32_t> colors_;
+};
+
+// Calls frame() until the time budget is spent and returns its summed
+// work per second
+template<typename F>
+double measure_rate(F&& frame, double seconds) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(seconds);
+    double work = 0.0;
+    auto now = start;
+    do {
+        work += frame();
+        now = std::chrono::steady_clock::now();
+    } while (now < deadline);
+    std::chrono::duration<double> elapsed = now - start;
+    return work / elapsed.count();
+}
+
+} // namespace
+
+SimdIsa raster_isa() {
+    SimdIsa best = SimdIsa::Scalar;
+    for (SimdIsa isa : detect_simd_isas()) {
+        if (isa == SimdIsa::SSE2 || isa == SimdIsa::AVX2) best = isa;
+    }
+    return best;
+}
+
+double run_raster_workload(TaskScheduler& scheduler, RasterWorkload workload, double seconds) {
+    RasterPipeline pipeline(scheduler, raster_isa(), workload == RasterWorkload::Geometry ? grid_scene() : fill_scene());
+
+    // The first frame touches the render targets and grows the bins
+    float angle = 0.0f;
+    pipeline.draw(angle);
+
+    switch (workload) {
+        case RasterWorkload::Geometry:
+            return measure_rate([&]() {
+                pipeline.draw(angle += kFrameAngle);
+                return static_cast<double>(pipeline.triangles());
+            }, seconds) / 1e6;
+        case RasterWorkload::Fill:
+            return measure_rate([&]() { return static_cast<double>(pipeline.draw(angle += kFrameAngle)); }, seconds) / 1e9;
+        case RasterWorkload::Shade:
+            return measure_rate([&]() { return static_cast<double>(pipeline.shade()); }, seconds) / 1e9;
+    }
+    return 0.0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "PCTester_SIMD.h"
+#include "PCTester_Scheduler.h"
+
+// Graphics-class workload for hosts without a usable GPU: a tiled software
+// rasterizer at 1920x1080. Each frame transforms the scene, sets up and
+// bins triangles into 64x64 tiles, then rasterizes every tile against a
+// z-buffer with SIMD edge functions. Setup chunks and tiles are scheduler
+// tasks, so the rates scale with the workers the way a GPU's do with its
+// shader cores.
+enum class RasterWorkload {
+    Geometry,   // ~115k small triangles per frame; Mtriangles/s
+    Fill,       // a few dozen screen-sized overlapping triangles; Gpixels/s
+    Shade       // compute-style lighting pass over the z-buffer; Gpixels/s
+};
+
+// Widest ISA the edge-function loops have a path for: AVX2, SSE2 or Scalar
+SimdIsa raster_isa();
+
+// Renders frames of one workload for roughly seconds and returns its rate
+// in the unit above. Fill counts every covered fragment, whether or not it
+// passed the depth test.
+double run_raster_workload(TaskScheduler& scheduler, RasterWorkload workload, double seconds);
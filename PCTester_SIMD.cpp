@@ -0,0 +1,415 @@
+#include "PCTester_SIMD.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define PCTESTER_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+    #include <sys/auxv.h>
+    #include <asm/hwcap.h>
+#endif
+
+// GCC and Clang need per-function target attributes to emit wider ISAs
+// without raising the baseline of the whole binary; MSVC accepts the
+// intrinsics anywhere.
+#if defined(__GNUC__)
+    #define SIMD_TARGET(isa) __attribute__((target(isa)))
+    #define SIMD_SCALAR __attribute__((optimize("no-tree-vectorize")))
+#else
+    #define SIMD_TARGET(isa)
+    #define SIMD_SCALAR
+#endif
+
+namespace {
+
+// Working sets stay L1/L2 resident so the kernels measure the core, not memory
+const size_t kDotElements = 4096;
+const size_t kSaxpyElements = 8192;
+const size_t kHashElements = 4096;
+const int kFmaAccumulators = 12;
+const uint64_t kFmaIterations = 1 << 16;
+
+struct KernelSet {
+    double (*fma)(uint64_t iterations);                       // returns checksum
+    double (*dot)(const double* x, const double* y, size_t n);
+    void (*saxpy)(float a, const float* x, float* y, size_t n);
+    void (*hash)(uint32_t* data, size_t n);
+    int double_lanes;
+};
+
+// ---- Scalar ---------------------------------------------------------------
+
+SIMD_SCALAR double fma_scalar(uint64_t iterations) {
+    double acc[kFmaAccumulators];
+    for (int j = 0; j < kFmaAccumulators; j++) acc[j] = j;
+    const double mul = 0.999999, add = 1e-7;
+    for (uint64_t i = 0; i < iterations; i++) {
+        for (int j = 0; j < kFmaAccumulators; j++) acc[j] = acc[j] * mul + add;
+    }
+    double sum = 0.0;
+    for (int j = 0; j < kFmaAccumulators; j++) sum += acc[j];
+    return sum;
+}
+
+SIMD_SCALAR double dot_scalar(const double* x, const double* y, size_t n) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    for (size_t i = 0; i < n; i += 4) {
+        s0 += x[i] * y[i];
+        s1 += x[i + 1] * y[i + 1];
+        s2 += x[i + 2] * y[i + 2];
+        s3 += x[i + 3] * y[i + 3];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+SIMD_SCALAR void saxpy_scalar(float a, const float* x, float* y, size_t n) {
+    for (size_t i = 0; i < n; i++) y[i] = a * x[i] + y[i];
+}
+
+SIMD_SCALAR void hash_scalar(uint32_t* data, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t h = data[i];
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        data[i] = h;
+    }
+}
+
+#if defined(PCTESTER_X86)
+
+// ---- SSE2 -----------------------------------------------------------------
+
+SIMD_TARGET("sse2") double fma_sse2(uint64_t iterations) {
+    __m128d acc[kFmaAccumulators];
+    for (int j = 0; j < kFmaAccumulators; j++) acc[j] = _mm_set1_pd(j);
+    const __m128d mul = _mm_set1_pd(0.999999), add = _mm_set1_pd(1e-7);
+    for (uint64_t i = 0; i < iterations; i++) {
+        for (int j = 0; j < kFmaAccumulators; j++) acc[j] = _mm_add_pd(_mm_mul_pd(acc[j], mul), add);
+    }
+    double lanes[2], sum = 0.0;
+    for (int j = 0; j < kFmaAccumulators; j++) {
+        _mm_storeu_pd(lanes, acc[j]);
+        sum += lanes[0] + lanes[1];
+    }
+    return sum;
+}
+
+SIMD_TARGET("sse2") double dot_sse2(const double* x, const double* y, size_t n) {
+    __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+    for (size_t i = 0; i < n; i += 4) {
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(s0, s1));
+    return lanes[0] + lanes[1];
+}
+
+SIMD_TARGET("sse2") void saxpy_sse2(float a, const float* x, float* y, size_t n) {
+    const __m128 va = _mm_set1_ps(a);
+    for (size_t i = 0; i < n; i += 4) {
+        __m128 vy = _mm_add_ps(_mm_mul_ps(va, _mm_loadu_ps(x + i)), _mm_loadu_ps(y + i));
+        _mm_storeu_ps(y + i, vy);
+    }
+}
+
+// SSE2 has no 32-bit mullo; build it from two 32x32->64 multiplies
+SIMD_TARGET("sse2") static inline __m128i mullo32_sse2(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+SIMD_TARGET("sse2") void hash_sse2(uint32_t* data, size_t n) {
+    const __m128i m1 = _mm_set1_epi32(static_cast<int>(0x85ebca6bu));
+    const __m128i m2 = _mm_set1_epi32(static_cast<int>(0xc2b2ae35u));
+    for (size_t i = 0; i < n; i += 4) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+        h = mullo32_sse2(h, m1);
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 13));
+        h = mullo32_sse2(h, m2);
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), h);
+    }
+}
+
+// ---- AVX2 + FMA -----------------------------------------------------------
+
+SIMD_TARGET("avx2,fma") double fma_avx2(uint64_t iterations) {
+    __m256d acc[kFmaAccumulators];
+    for (int j = 0; j < kFmaAccumulators; j++) acc[j] = _mm256_set1_pd(j);
+    const __m256d mul = _mm256_set1_pd(0.999999), add = _mm256_set1_pd(1e-7);
+    for (uint64_t i = 0; i < iterations; i++) {
+        for (int j = 0; j < kFmaAccumulators; j++) acc[j] = _mm256_fmadd_pd(acc[j], mul, add);
+    }
+    double lanes[4], sum = 0.0;
+    for (int j = 0; j < kFmaAccumulators; j++) {
+        _mm256_storeu_pd(lanes, acc[j]);
+        sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    return sum;
+}
+
+SIMD_TARGET("avx2,fma") double dot_avx2(const double* x, const double* y, size_t n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    for (size_t i = 0; i < n; i += 16) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), s1);
+        s2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(y + i + 8), s2);
+        s3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12), s3);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+SIMD_TARGET("avx2,fma") void saxpy_avx2(float a, const float* x, float* y, size_t n) {
+    const __m256 va = _mm256_set1_ps(a);
+    for (size_t i = 0; i < n; i += 8) {
+        __m256 vy = _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i));
+        _mm256_storeu_ps(y + i, vy);
+    }
+}
+
+SIMD_TARGET("avx2,fma") void hash_avx2(uint32_t* data, size_t n) {
+    const __m256i m1 = _mm256_set1_epi32(static_cast<int>(0x85ebca6bu));
+    const __m256i m2 = _mm256_set1_epi32(static_cast<int>(0xc2b2ae35u));
+    for (size_t i = 0; i < n; i += 8) {
+        __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+        h = _mm256_mullo_epi32(h, m1);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+        h = _mm256_mullo_epi32(h, m2);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), h);
+    }
+}
+
+// ---- AVX-512F -------------------------------------------------------------
+
+SIMD_TARGET("avx512f") double fma_avx512(uint64_t iterations) {
+    __m512d acc[kFmaAccumulators];
+    for (int j = 0; j < kFmaAccumulators; j++) acc[j] = _mm512_set1_pd(j);
+    const __m512d mul = _mm512_set1_pd(0.999999), add = _mm512_set1_pd(1e-7);
+    for (uint64_t i = 0; i < iterations; i++) {
+        for (int j = 0; j < kFmaAccumulators; j++) acc[j] = _mm512_fmadd_pd(acc[j], mul, add);
+    }
+    double sum = 0.0;
+    for (int j = 0; j < kFmaAccumulators; j++) sum += _mm512_reduce_add_pd(acc[j]);
+    return sum;
+}
+
+SIMD_TARGET("avx512f") double dot_avx512(const double* x, const double* y, size_t n) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+    __m512d s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+    for (size_t i = 0; i < n; i += 32) {
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), s0);
+        s1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), s1);
+        s2 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 16), _mm512_loadu_pd(y + i + 16), s2);
+        s3 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 24), _mm512_loadu_pd(y + i + 24), s3);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+}
+
+SIMD_TARGET("avx512f") void saxpy_avx512(float a, const float* x, float* y, size_t n) {
+    const __m512 va = _mm512_set1_ps(a);
+    for (size_t i = 0; i < n; i += 16) {
+        __m512 vy = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i));
+        _mm512_storeu_ps(y + i, vy);
+    }
+}
+
+SIMD_TARGET("avx512f") void hash_avx512(uint32_t* data, size_t n) {
+    const __m512i m1 = _mm512_set1_epi32(static_cast<int>(0x85ebca6bu));
+    const __m512i m2 = _mm512_set1_epi32(static_cast<int>(0xc2b2ae35u));
+    for (size_t i = 0; i < n; i += 16) {
+        __m512i h = _mm512_loadu_si512(data + i);
+        h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+        h = _mm512_mullo_epi32(h, m1);
+        h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 13));
+        h = _mm512_mullo_epi32(h, m2);
+        h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+        _mm512_storeu_si512(data + i, h);
+    }
+}
+
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int out[4];
+    __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; i++) regs[i] = static_cast<uint32_t>(out[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// XCR0 tells us which register state the OS saves on context switch
+uint64_t read_xcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+#endif // PCTESTER_X86
+
+KernelSet kernels_for(SimdIsa isa) {
+    switch (isa) {
+#if defined(PCTESTER_X86)
+        case SimdIsa::SSE2:   return { fma_sse2, dot_sse2, saxpy_sse2, hash_sse2, 2 };
+        case SimdIsa::AVX2:   return { fma_avx2, dot_avx2, saxpy_avx2, hash_avx2, 4 };
+        case SimdIsa::AVX512: return { fma_avx512, dot_avx512, saxpy_avx512, hash_avx512, 8 };
+#endif
+        default:              return { fma_scalar, dot_scalar, saxpy_scalar, hash_scalar, 1 };
+    }
+}
+
+// Calls chunk() until the time budget is spent and returns work units per second
+template<typename F>
+double measure_rate(F&& chunk, double work_per_chunk, double seconds) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(seconds);
+    uint64_t chunks = 0;
+    auto now = start;
+    do {
+        chunk();
+        chunks++;
+        now = std::chrono::steady_clock::now();
+    } while (now < deadline);
+    std::chrono::duration<double> elapsed = now - start;
+    return chunks * work_per_chunk / elapsed.count();
+}
+
+} // namespace
+
+const char* simd_isa_name(SimdIsa isa) {
+    switch (isa) {
+        case SimdIsa::SSE2:   return "SSE2";
+        case SimdIsa::AVX2:   return "AVX2";
+        case SimdIsa::AVX512: return "AVX-512";
+        default:              return "Scalar";
+    }
+}
+
+std::vector<SimdIsa> detect_simd_isas() {
+    std::vector<SimdIsa> isas = { SimdIsa::Scalar };
+#if defined(PCTESTER_X86)
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    uint32_t max_leaf = regs[0];
+
+    cpuid(1, 0, regs);
+    bool sse2 = regs[3] & (1u << 26);
+    bool osxsave = regs[2] & (1u << 27);
+    bool avx = regs[2] & (1u << 28);
+    bool fma = regs[2] & (1u << 12);
+    if (sse2) isas.push_back(SimdIsa::SSE2);
+
+    if (!osxsave || !avx || max_leaf < 7) return isas;
+    uint64_t xcr0 = read_xcr0();
+    bool ymm_state = (xcr0 & 0x6) == 0x6;
+    bool zmm_state = (xcr0 & 0xe6) == 0xe6;
+
+    cpuid(7, 0, regs);
+    bool avx2 = regs[1] & (1u << 5);
+    bool avx512f = regs[1] & (1u << 16);
+    if (ymm_state && avx2 && fma) isas.push_back(SimdIsa::AVX2);
+    if (zmm_state && avx512f) isas.push_back(SimdIsa::AVX512);
+#endif
+    return isas;
+}
+
+CpuExtensions detect_cpu_extensions() {
+    CpuExtensions extensions{};
+#if defined(PCTESTER_X86)
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    uint32_t max_leaf = regs[0];
+
+    cpuid(1, 0, regs);
+    bool ssse3 = regs[2] & (1u << 9);
+    bool sse41 = regs[2] & (1u << 19);
+    extensions.crc32c = regs[2] & (1u << 20);
+    extensions.aes = regs[2] & (1u << 25);
+    if (max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        extensions.sha256 = ssse3 && sse41 && (regs[1] & (1u << 29));
+    }
+#elif defined(__aarch64__) && defined(__linux__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    extensions.crc32c = hwcap & HWCAP_CRC32;
+    extensions.aes = hwcap & HWCAP_AES;
+    extensions.sha256 = hwcap & HWCAP_SHA2;
+#elif defined(__aarch64__) && defined(__APPLE__)
+    // Every Apple arm64 core has the CRC32 and crypto extensions
+    extensions.crc32c = extensions.aes = extensions.sha256 = true;
+#endif
+    return extensions;
+}
+
+double run_simd_kernel(SimdIsa isa, SimdKernel kernel, double seconds) {
+    KernelSet k = kernels_for(isa);
+    volatile double sink = 0.0;
+
+    switch (kernel) {
+        case SimdKernel::Fma: {
+            // Every accumulator does one multiply and one add per lane
+            double fma_flops = 2.0 * kFmaAccumulators * k.double_lanes * kFmaIterations;
+            return measure_rate([&]() { sink = sink + k.fma(kFmaIterations); }, fma_flops, seconds) / 1e9;
+        }
+        case SimdKernel::Dot: {
+            std::vector<double> x(kDotElements), y(kDotElements);
+            for (size_t i = 0; i < kDotElements; i++) {
+                x[i] = 1.0 / (i + 1);
+                y[i] = 1.0 - x[i];
+            }
+            return measure_rate([&]() { sink = sink + k.dot(x.data(), y.data(), kDotElements); },
+                                2.0 * kDotElements, seconds) / 1e9;
+        }
+        case SimdKernel::Saxpy: {
+            // SAXPY reads x and y and writes y: 12 bytes per element
+            std::vector<float> xs(kSaxpyElements, 1.0f), ys(kSaxpyElements, 0.0f);
+            double rate = measure_rate([&]() { k.saxpy(1e-6f, xs.data(), ys.data(), kSaxpyElements); },
+                                       12.0 * kSaxpyElements, seconds) / 1e9;
+            sink = sink + ys[0];
+            return rate;
+        }
+        case SimdKernel::Hash: {
+            std::vector<uint32_t> words(kHashElements);
+            for (size_t i = 0; i < kHashElements; i++) words[i] = static_cast<uint32_t>(i * 2654435761u);
+            double rate = measure_rate([&]() { k.hash(words.data(), kHashElements); },
+                                       static_cast<double>(kHashElements), seconds) / 1e9;
+            sink = sink + words[0];
+            return rate;
+        }
+    }
+    return 0.0;
+}
+
+SimdScore run_simd_kernels(SimdIsa isa, double seconds_per_kernel) {
+    SimdScore score{};
+    score.isa = simd_isa_name(isa);
+    score.fma_gflops = run_simd_kernel(isa, SimdKernel::Fma, seconds_per_kernel);
+    score.dot_gflops = run_simd_kernel(isa, SimdKernel::Dot, seconds_per_kernel);
+    score.saxpy_gbs = run_simd_kernel(isa, SimdKernel::Saxpy, seconds_per_kernel);
+    score.hash_gops = run_simd_kernel(isa, SimdKernel::Hash, seconds_per_kernel);
+    return score;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "PCTester.h"
+#include <string>
+#include <vector>
+
+// Instruction set levels the vector kernels are compiled for. Each level is
+// built into the same binary and picked at runtime from cpuid, so a host
+// only ever runs the code paths its CPU and OS actually support.
+enum class SimdIsa {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+enum class SimdKernel {
+    Fma,        // GFLOPS
+    Dot,        // GFLOPS
+    Saxpy,      // GB/s
+    Hash        // G words/s
+};
+
+const char* simd_isa_name(SimdIsa isa);
+
+// All ISA levels usable on this host, lowest first. Scalar is always present.
+std::vector<SimdIsa> detect_simd_isas();
+
+// Scalar-unit extensions used by the integer and crypto workloads: SSE4.2,
+// AES-NI and SHA-NI on x86, the CRC32 and crypto extensions on ARMv8
+struct CpuExtensions {
+    bool crc32c;    // crc32 instruction (Castagnoli polynomial)
+    bool aes;
+    bool sha256;    // on x86 with the SSSE3/SSE4.1 shuffles its code needs
+};
+
+CpuExtensions detect_cpu_extensions();
+
+// Runs one kernel for roughly seconds and returns its rate in the unit above
+double run_simd_kernel(SimdIsa isa, SimdKernel kernel, double seconds);
+
+// Runs the FMA, dot product, SAXPY and integer hash kernels for one ISA,
+// spending roughly seconds_per_kernel on each.
+SimdScore run_simd_kernels(SimdIsa isa, double seconds_per_kernel);
@@ -0,0 +1,248 @@
+#include "PCTester_Scheduler.h"
+#include <chrono>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <sched.h>
+    #include <unistd.h>
+#elif defined(__APPLE__)
+    #include <mach/mach.h>
+    #include <mach/thread_policy.h>
+    #include <pthread.h>
+#endif
+
+namespace {
+
+// Steal rounds an idle worker makes before it goes to sleep
+const int kIdleSpins = 64;
+
+// Worker of the scheduler the current thread belongs to, if any
+thread_local TaskScheduler* tls_scheduler = nullptr;
+thread_local void* tls_worker = nullptr;
+
+// Pins the calling thread to the index-th CPU the process may run on
+void pin_current_thread(size_t index) {
+#if defined(_WIN32)
+    DWORD_PTR process_mask = 0, system_mask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) || process_mask == 0) return;
+    std::vector<DWORD_PTR> cpus;
+    for (int bit = 0; bit < static_cast<int>(sizeof(DWORD_PTR) * 8); bit++) {
+        if (process_mask & (static_cast<DWORD_PTR>(1) << bit)) cpus.push_back(static_cast<DWORD_PTR>(1) << bit);
+    }
+    SetThreadAffinityMask(GetCurrentThread(), cpus[index % cpus.size()]);
+#elif defined(__linux__)
+    // The main thread's mask, in case the pool is built on a pinned thread
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(getpid(), sizeof(allowed), &allowed) != 0) return;
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+    }
+    if (cpus.empty()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[index % cpus.size()], &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#elif defined(__APPLE__)
+    // macOS has no hard affinity; distinct tags ask the kernel to keep
+    // workers on different cores
+    thread_affinity_policy_data_t policy = { static_cast<integer_t>(index + 1) };
+    thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_AFFINITY_POLICY,
+                      reinterpret_cast<thread_policy_t>(&policy), THREAD_AFFINITY_POLICY_COUNT);
+#else
+    (void)index;
+#endif
+}
+
+} // namespace
+
+WorkStealingDeque::WorkStealingDeque(int64_t capacity) : top_(0), bottom_(0) {
+    rings_.push_back(std::make_unique<Ring>(capacity));
+    ring_.store(rings_.back().get(), std::memory_order_relaxed);
+}
+
+WorkStealingDeque::~WorkStealingDeque() = default;
+
+WorkStealingDeque::Ring* WorkStealingDeque::grow(Ring* ring, int64_t bottom, int64_t top) {
+    rings_.push_back(std::make_unique<Ring>(ring->capacity() * 2));
+    Ring* bigger = rings_.back().get();
+    for (int64_t i = top; i < bottom; i++) bigger->put(i, ring->get(i));
+    ring_.store(bigger, std::memory_order_release);
+    return bigger;
+}
+
+void WorkStealingDeque::push(TaskBase* task) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    Ring* ring = ring_.load(std::memory_order_relaxed);
+    if (bottom - top > ring->capacity() - 1) ring = grow(ring, bottom, top);
+    ring->put(bottom, task);
+    // Publishes the task (and everything written to it) to thieves
+    bottom_.store(bottom + 1, std::memory_order_release);
+}
+
+TaskBase* WorkStealingDeque::pop() {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Ring* ring = ring_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    
+    if (top > bottom) {
+        // Already empty
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    TaskBase* task = ring->get(bottom);
+    if (top == bottom) {
+        // Last element: race any thief for it
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+TaskBase* WorkStealingDeque::steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) return nullptr;
+    
+    Ring* ring = ring_.load(std::memory_order_acquire);
+    TaskBase* task = ring->get(top);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+TaskScheduler::TaskScheduler(size_t workers, bool pin_workers)
+    : queued_(0), sleepers_(0), waiters_(0), stopping_(false) {
+    if (workers == 0) workers = std::thread::hardware_concurrency();
+    if (workers == 0) workers = 1;
+    for (size_t i = 0; i < workers; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+        workers_.back()->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+    }
+    // Threads start only after every Worker exists, since they steal from each other
+    for (size_t i = 0; i < workers; i++) {
+        workers_[i]->thread = std::thread(&TaskScheduler::worker_loop, this, i, pin_workers);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    stopping_.store(true, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.notify_all();
+    }
+    for (auto& worker : workers_) worker->thread.join();
+}
+
+void TaskScheduler::enqueue(TaskBase* task) {
+    if (tls_scheduler == this) {
+        static_cast<Worker*>(tls_worker)->deque.push(task);
+    } else {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        injected_.push_back(task);
+    }
+    queued_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.notify_one();
+    }
+}
+
+// Own deque first (LIFO, cache-warm), then the injection queue, then a
+// sweep over the other workers starting at a random victim
+TaskBase* TaskScheduler::find_task(Worker* self) {
+    TaskBase* task = self ? self->deque.pop() : nullptr;
+    if (!task && queued_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        if (!injected_.empty()) {
+            task = injected_.front();
+            injected_.pop_front();
+        }
+    }
+    if (!task && self && workers_.size() > 1) {
+        self->rng ^= self->rng << 13;
+        self->rng ^= self->rng >> 7;
+        self->rng ^= self->rng << 17;
+        size_t start = static_cast<size_t>(self->rng % workers_.size());
+        for (size_t i = 0; i < workers_.size() && !task; i++) {
+            Worker* victim = workers_[(start + i) % workers_.size()].get();
+            if (victim != self) task = victim->deque.steal();
+        }
+    }
+    if (task) queued_.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+}
+
+void TaskScheduler::run_task(TaskBase* task) {
+    task->execute();
+    if (waiters_.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        wait_cv_.notify_all();
+    }
+    task->release();
+}
+
+void TaskScheduler::worker_loop(size_t index, bool pin) {
+    Worker* self = workers_[index].get();
+    tls_scheduler = this;
+    tls_worker = self;
+    if (pin) pin_current_thread(index);
+    
+    while (true) {
+        TaskBase* task = find_task(self);
+        for (int spin = 0; !task && spin < kIdleSpins; spin++) {
+            std::this_thread::yield();
+            task = find_task(self);
+        }
+        if (task) {
+            run_task(task);
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        sleep_cv_.wait(lock, [this]() {
+            return queued_.load(std::memory_order_seq_cst) > 0 || stopping_.load(std::memory_order_seq_cst);
+        });
+        sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+        if (stopping_.load() && queued_.load() == 0) return;
+    }
+}
+
+void TaskScheduler::wait(const TaskBase& task) {
+    Worker* self = tls_scheduler == this ? static_cast<Worker*>(tls_worker) : nullptr;
+    int idle = 0;
+    while (!task.done()) {
+        // A worker runs queued tasks while it waits, so nested submits
+        // always make progress even when every worker is blocked in get()
+        if (self) {
+            TaskBase* other = find_task(self);
+            if (other) {
+                run_task(other);
+                idle = 0;
+                continue;
+            }
+            if (++idle < kIdleSpins) {
+                std::this_thread::yield();
+                continue;
+            }
+        }
+        // Nothing to help with: sleep rather than burn a CPU that a
+        // benchmark may be measuring. Workers wake up periodically to
+        // look for new tasks.
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        if (self) wait_cv_.wait_for(lock, std::chrono::milliseconds(1), [&task]() { return task.done(); });
+        else wait_cv_.wait(lock, [&task]() { return task.done(); });
+        waiters_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
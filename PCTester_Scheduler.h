@@ -0,0 +1,252 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class TaskScheduler;
+
+// Common header of every scheduled task. The callable, its arguments and
+// the result slot live in one TaskState allocation that the scheduler and
+// the Future share through an intrusive reference count, so a submit costs
+// exactly one heap allocation and no std::function or packaged_task.
+class TaskBase {
+public:
+    explicit TaskBase(TaskScheduler* owner) : owner_(owner), refs_(2), done_(false) {}
+    virtual ~TaskBase() = default;
+    
+    void execute() {
+        run();
+        done_.store(true, std::memory_order_seq_cst);
+    }
+    bool done() const { return done_.load(std::memory_order_seq_cst); }
+    TaskScheduler* owner() const { return owner_; }
+    
+    void release() {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+    
+protected:
+    virtual void run() = 0;
+    
+private:
+    TaskScheduler* owner_;
+    std::atomic<int> refs_;
+    std::atomic<bool> done_;
+};
+
+template<typename R>
+class TaskResult : public TaskBase {
+public:
+    using TaskBase::TaskBase;
+    ~TaskResult() override {
+        if (has_value_) reinterpret_cast<R*>(&value_)->~R();
+    }
+    
+    R take() {
+        if (error_) std::rethrow_exception(error_);
+        return std::move(*reinterpret_cast<R*>(&value_));
+    }
+    
+protected:
+    template<typename F>
+    void capture(F& fn) {
+        try {
+            new (&value_) R(fn());
+            has_value_ = true;
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+    }
+    
+private:
+    typename std::aligned_storage<sizeof(R), alignof(R)>::type value_;
+    bool has_value_ = false;
+    std::exception_ptr error_;
+};
+
+template<>
+class TaskResult<void> : public TaskBase {
+public:
+    using TaskBase::TaskBase;
+    
+    void take() {
+        if (error_) std::rethrow_exception(error_);
+    }
+    
+protected:
+    template<typename F>
+    void capture(F& fn) {
+        try {
+            fn();
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+    }
+    
+private:
+    std::exception_ptr error_;
+};
+
+template<typename R, typename F>
+class TaskState final : public TaskResult<R> {
+public:
+    TaskState(TaskScheduler* owner, F&& fn) : TaskResult<R>(owner), fn_(std::move(fn)) {}
+    
+private:
+    void run() override { this->capture(fn_); }
+    F fn_;
+};
+
+// Result of TaskScheduler::submit. get() blocks until the task has run;
+// when called from a worker of the same scheduler it executes other queued
+// tasks while waiting instead of sleeping, so nested submits cannot
+// deadlock the pool.
+template<typename R>
+class Future {
+public:
+    Future() : task_(nullptr) {}
+    explicit Future(TaskResult<R>* task) : task_(task) {}
+    Future(Future&& other) noexcept : task_(other.task_) { other.task_ = nullptr; }
+    Future& operator=(Future&& other) noexcept {
+        if (this != &other) {
+            if (task_) task_->release();
+            task_ = other.task_;
+            other.task_ = nullptr;
+        }
+        return *this;
+    }
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+    ~Future() {
+        if (task_) task_->release();
+    }
+    
+    bool valid() const { return task_ != nullptr; }
+    bool ready() const { return task_ && task_->done(); }
+    void wait() const;
+    R get();
+    
+private:
+    TaskResult<R>* task_;
+};
+
+// Chase-Lev work-stealing deque. The owning worker pushes and pops at the
+// bottom without locks; thieves take from the top with a single CAS. The
+// ring doubles when full; retired rings are kept until destruction because
+// a concurrent thief may still be reading from them.
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(int64_t capacity = 256);
+    ~WorkStealingDeque();
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    
+    void push(TaskBase* task);   // owner only
+    TaskBase* pop();             // owner only
+    TaskBase* steal();           // any thread
+    
+private:
+    struct Ring {
+        explicit Ring(int64_t capacity) : mask(capacity - 1), slots(new std::atomic<TaskBase*>[capacity]) {}
+        int64_t capacity() const { return mask + 1; }
+        TaskBase* get(int64_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+        void put(int64_t index, TaskBase* task) { slots[index & mask].store(task, std::memory_order_relaxed); }
+        
+        int64_t mask;
+        std::unique_ptr<std::atomic<TaskBase*>[]> slots;
+    };
+    
+    Ring* grow(Ring* ring, int64_t bottom, int64_t top);
+    
+    alignas(64) std::atomic<int64_t> top_;
+    alignas(64) std::atomic<int64_t> bottom_;
+    std::atomic<Ring*> ring_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+};
+
+// Fixed pool of workers, each optionally pinned to one CPU of the process
+// affinity mask. Tasks submitted from a worker go to its own deque; tasks
+// from other threads go to a shared injection queue. Idle workers steal
+// from random victims, spin briefly, then sleep so an idle pool does not
+// disturb the benchmarks running beside it.
+class TaskScheduler {
+public:
+    // 0 workers means one per hardware thread
+    explicit TaskScheduler(size_t workers = 0, bool pin_workers = true);
+    ~TaskScheduler();
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+    
+    size_t worker_count() const { return workers_.size(); }
+    
+    template<typename F, typename... Args>
+    auto submit(F&& f, Args&&... args) -> Future<std::invoke_result_t<F, Args...>>;
+    
+    // Blocks until task is done, helping with queued work when called
+    // from one of this scheduler's workers
+    void wait(const TaskBase& task);
+    
+private:
+    struct Worker {
+        WorkStealingDeque deque;
+        std::thread thread;
+        uint64_t rng;
+    };
+    
+    void enqueue(TaskBase* task);
+    TaskBase* find_task(Worker* self);
+    void run_task(TaskBase* task);
+    void worker_loop(size_t index, bool pin);
+    
+    std::vector<std::unique_ptr<Worker>> workers_;
+    
+    std::mutex inject_mutex_;
+    std::deque<TaskBase*> injected_;
+    
+    // Tasks queued but not yet picked up; sleeping workers wait on it
+    std::atomic<int64_t> queued_;
+    std::atomic<int> sleepers_;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    
+    // External threads blocked in wait()
+    std::atomic<int> waiters_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+    
+    std::atomic<bool> stopping_;
+};
+
+template<typename F, typename... Args>
+auto TaskScheduler::submit(F&& f, Args&&... args) -> Future<std::invoke_result_t<F, Args...>> {
+    using R = std::invoke_result_t<F, Args...>;
+    auto bound = [fn = std::forward<F>(f), tuple = std::make_tuple(std::forward<Args>(args)...)]() mutable -> R {
+        return std::apply(fn, tuple);
+    };
+    auto* task = new TaskState<R, decltype(bound)>(this, std::move(bound));
+    enqueue(task);
+    return Future<R>(task);
+}
+
+template<typename R>
+void Future<R>::wait() const {
+    if (task_ && !task_->done()) task_->owner()->wait(*task_);
+}
+
+template<typename R>
+R Future<R>::get() {
+    wait();
+    return task_->take();
+}
@@ -1,12 +1,25 @@
 #include "PCTester_Windows.h"
+#include "PCTester_Harness.h"
+#include "PCTester_Export.h"
+#include "PCTester_Baseline.h"
 #include <iostream>
+#include <cstdio>
 #include <iomanip>
 #include <cmath>
 #include <random>
 #include <algorithm>
 
-PCTester::Impl::Impl() {
+PCTester::Impl::Impl(const TestConfig& config) : config(config) {
     collect_system_info();
+    if (config.metrics_port) SafeOutput::error("Metrics endpoint is only available on Linux");
+}
+
+void PCTester::Impl::network_server(uint16_t) {
+    SafeOutput::error("Network server mode is only available on Linux");
+}
+
+void PCTester::Impl::run_daemon() {
+    SafeOutput::error("Daemon mode is only available on Linux");
 }
 
 PCTester::Impl::~Impl() {
@@ -145,16 +158,29 @@ void PCTester::Impl::collect_system_info() {
     CoUninitialize();
 }
 
-void PCTester::Impl::run_full_diagnostics() {
+const std::vector<PCTester::Impl::Stage>& PCTester::Impl::stages() {
+    static const std::vector<Stage> all = { { "CPU", &Impl::cpu_benchmark }, { "GPU", &Impl::gpu_benchmark } };
+    return all;
+}
+
+std::vector<std::string> PCTester::Impl::stage_names() {
+    std::vector<std::string> names;
+    for (const Stage& stage : stages()) names.push_back(stage.first);
+    return names;
+}
+
+void PCTester::Impl::run_stages(const std::vector<std::string>& names) {
     SafeOutput::print("\n=== Advanced Diagnostics ===");
     
     // Start temperature monitoring
     std::atomic<bool> stop_monitoring(false);
     std::thread temp_monitor(&Impl::monitor_temperatures, this, std::ref(stop_monitoring));
     
-    // Run tests
-    cpu_benchmark();
-    gpu_benchmark();
+    // Run tests, each stage as a scheduler task
+    for (const Stage& stage : stages()) {
+        if (std::find(names.begin(), names.end(), stage.first) == names.end()) continue;
+        scheduler.submit(stage.second, this).get();
+    }
     
     // Stop monitoring
     stop_monitoring = true;
@@ -182,21 +208,27 @@ void PCTester::Impl::cpu_benchmark() {
         RegCloseKey(hKey);
     }
     
-    // Run complex mathematical operations
-    const int num_iterations = 100000000;
-    double pi = 0.0;
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    for (int i = 0; i < num_iterations; i++) {
-        pi += 4.0 * (1 - (i % 2) * 2) / (2 * i + 1);
-    }
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
+    // Run complex mathematical operations, repeated until the rate is stable
+    const int num_iterations = 20000000;
+    volatile double sink = 0.0;
+    BenchmarkStats stats = run_benchmark("Series", "Miter/s", BenchmarkOptions::from(config), [&]() {
+        double pi = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        
+        for (int i = 0; i < num_iterations; i++) {
+            pi += 4.0 * (1 - (i % 2) * 2) / (2 * i + 1);
+        }
+        sink = sink + pi;
+        
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return num_iterations / elapsed.count() / 1e6;
+    });
+    test_results.bench_stats.push_back(stats);
+    SafeOutput::print("[CPU] Series: " + format_stats(stats));
     
     // Calculate score
     double base_perf = (dwMHz / 1000.0) * 4;  // Assuming 4 cores
-    double actual_perf = num_iterations / elapsed.count();
+    double actual_perf = stats.median * 1e6;
     test_results.cpu_score = (actual_perf / base_perf) * 10000;
     test_results.cpu_temp = get_cpu_temperature();
     
@@ -247,9 +279,6 @@ void PCTester::Impl::gpu_benchmark() {
         sys_info.gpu_memory = adapterDesc.DedicatedVideoMemory / (1024 * 1024);
     }
     
-    // Run simple benchmark
-    auto start = std::chrono::high_resolution_clock::now();
-    
     // Create a simple vertex buffer
     float vertices[] = {
          0.0f,  0.5f, 0.0f,
@@ -272,18 +301,24 @@ void PCTester::Impl::gpu_benchmark() {
         pContext->IASetVertexBuffers(0, 1, &pVertexBuffer, &stride, &offset);
         pContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
         
-        // Render 100,000 triangles
-        for (int i = 0; i < 100000; i++) {
-            pContext->Draw(3, 0);
-        }
+        // Render 100,000 triangles per run; Flush submits them so each run
+        // pays for its own batch
+        BenchmarkStats stats = run_benchmark("Draw calls", "draws/s", BenchmarkOptions::from(config), [&]() {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < 100000; i++) {
+                pContext->Draw(3, 0);
+            }
+            pContext->Flush();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            return 100000 / elapsed.count();
+        });
+        test_results.bench_stats.push_back(stats);
+        SafeOutput::print("[GPU] Draw calls: " + format_stats(stats));
+        
+        // Calculate GPU score
+        test_results.gpu_score = stats.median;
     }
     
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
-    
-    // Calculate GPU score
-    test_results.gpu_score = 100000 / elapsed.count();
-    
     // Cleanup
     if (pVertexBuffer) pVertexBuffer->Release();
     if (pAdapter) pAdapter->Release();
@@ -320,10 +355,10 @@ void PCTester::Impl::monitor_temperatures(std::atomic<bool>& stop_monitoring) {
         double cpu_temp = get_cpu_temperature();
         double gpu_temp = get_gpu_temperature();
         
-        std::stringstream ss;
-        ss << "[TEMP] CPU: " << std::fixed << std::setprecision(1) << cpu_temp << "°C";
-        ss << " | GPU: " << gpu_temp << "°C";
-        SafeOutput::print(ss.str());
+        // Formatted on the stack: this thread runs beside timed sections
+        char line[64];
+        int length = snprintf(line, sizeof(line), "[TEMP] CPU: %.1f°C | GPU: %.1f°C", cpu_temp, gpu_temp);
+        SafeOutput::print(line, length > 0 ? std::min<size_t>(length, sizeof(line) - 1) : 0);
         
         std::this_thread::sleep_for(std::chrono::seconds(2));
     }
@@ -407,6 +442,8 @@ void PCTester::Impl::generate_html_report(const std::string& filename) const {
             <li>CPU performance is )" << (test_results.cpu_score > 5000 ? "excellent" : "adequate") << R"(</li>
             <li>GPU performance is )" << (test_results.gpu_score > 500 ? "excellent" : "adequate") << R"(</li>
             <li>System is running within safe temperature ranges</li>
+            )" << (test_results.baseline_source.empty() ? std::string() :
+                   "<li>" + std::to_string(test_results.baseline_regressions) + " significant regression(s) against the baseline</li>") << R"(
         </ul>
     </div>
 </body>
@@ -414,3 +451,14 @@ void PCTester::Impl::generate_html_report(const std::string& filename) const {
     
     SafeOutput::print("Report generated: " + filename);
 }
+
+void PCTester::Impl::export_results(const std::string& filename, ResultFormat format) const {
+    if (!export_results_file(filename, format, sys_info, test_results)) {
+        throw std::runtime_error("Failed to write results file");
+    }
+    SafeOutput::print("Results exported: " + filename);
+}
+
+int PCTester::Impl::compare_to_baseline(const std::string& path) {
+    return apply_baseline(path, config.regression_threshold_pct, sys_info, test_results);
+}
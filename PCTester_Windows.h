@@ -1,6 +1,7 @@
 #pragma once
 
 #include "PCTester.h"
+#include "PCTester_Scheduler.h"
 #include <windows.h>
 #include <wincrypt.h>
 #include <pdh.h>
@@ -26,15 +27,25 @@
 
 class PCTester::Impl {
 public:
-    Impl();
+    explicit Impl(const TestConfig& config);
     ~Impl();
     
-    void run_full_diagnostics();
+    void run_stages(const std::vector<std::string>& names);
+    static std::vector<std::string> stage_names();
     void generate_html_report(const std::string& filename) const;
+    void export_results(const std::string& filename, ResultFormat format) const;
+    int compare_to_baseline(const std::string& path);
+    void run_daemon();
+    static void network_server(uint16_t port);
     
 private:
+    TestConfig config;
     SystemInfo sys_info;
     TestResults test_results;
+    TaskScheduler scheduler;
+    
+    using Stage = std::pair<const char*, void (Impl::*)()>;
+    static const std::vector<Stage>& stages();
     
     void collect_system_info();
     void cpu_benchmark();
@@ -0,0 +1,810 @@
+#include "PCTester_Workloads.h"
+#include "PCTester_SIMD.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <random>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define PCTESTER_X86_64 1
+    #include <immintrin.h>
+#elif defined(__aarch64__)
+    #define PCTESTER_ARM64 1
+    #include <arm_acle.h>
+    #include <arm_neon.h>
+#endif
+
+// Same per-function targeting as the SIMD kernels. Clang spells ARM
+// features differently, but every arm64 target it builds for by default
+// (Apple, Windows) already has them.
+#if defined(__GNUC__)
+    #define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define SIMD_TARGET(isa)
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+    #define ARM_TARGET(features) __attribute__((target(features)))
+#else
+    #define ARM_TARGET(features)
+#endif
+
+namespace {
+
+// Hashed, encrypted and compressed buffers stay L2 resident so the kernels
+// measure the core, not memory
+const size_t kBufferBytes = 256 << 10;
+const size_t kSortKeys = 1 << 16;
+
+// LZ77 parameters close to zlib's default level
+const size_t kLzWindow = 1 << 15;
+const size_t kLzHashBits = 15;
+const size_t kLzMinMatch = 4;
+const size_t kLzMaxMatch = 258;
+const int kLzMaxChain = 32;
+
+// CRC32C streams run in 4 KiB blocks, three at a time
+const size_t kCrcBlock = 4096;
+
+const size_t kProgramLength = 4096;
+const uint64_t kInterpreterSteps = 1 << 20;
+
+// Reference rates, rounded from one core of the calibration host (a
+// virtualized Xeon with SSE4.2, AES-NI and SHA-NI): that core scores about
+// 1000 on every kernel
+const CpuWorkloadInfo kWorkloads[] = {
+    { "LZ match finding", "MB/s", 30.0, 0.15, false },
+    { "CRC32C", "GB/s", 16.0, 0.10, true },
+    { "XXH64", "GB/s", 8.0, 0.10, false },
+    { "AES-128-CTR", "GB/s", 4.5, 0.10, true },
+    { "SHA-256", "MB/s", 750.0, 0.10, true },
+    { "Sort", "Mkeys/s", 10.0, 0.15, false },
+    { "Interpreter", "Minstr/s", 60.0, 0.15, false },
+};
+
+const CpuWorkloadInfo kFpSeries = { "FP series", "Mterms/s", 550.0, 0.15, false };
+
+const char* const kPortableEngine = "portable";
+
+uint64_t load64(const uint8_t* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t load32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+uint32_t rotr32(uint32_t x, int r) { return (x >> r) | (x << (32 - r)); }
+
+// Log-like text: words from a fixed vocabulary, so the LZ kernel finds
+// matches at realistic distances
+std::vector<uint8_t> make_corpus(size_t bytes) {
+    std::mt19937 rng(1234);
+    std::vector<std::string> words(512);
+    for (auto& word : words) {
+        size_t length = 2 + rng() % 9;
+        for (size_t i = 0; i < length; i++) word += static_cast<char>('a' + rng() % 26);
+    }
+    std::vector<uint8_t> corpus;
+    corpus.reserve(bytes + 16);
+    while (corpus.size() < bytes) {
+        const std::string& word = rng() % 8 ? words[rng() % 64] : words[rng() % words.size()];
+        corpus.insert(corpus.end(), word.begin(), word.end());
+        corpus.push_back(rng() % 12 ? ' ' : '\n');
+    }
+    corpus.resize(bytes);
+    return corpus;
+}
+
+// ---- LZ match finding ------------------------------------------------------
+
+// Greedy parse with hash chains; returns the bytes covered by matches
+uint64_t lz_match(const uint8_t* data, size_t n, std::vector<int32_t>& head, std::vector<int32_t>& chain) {
+    std::fill(head.begin(), head.end(), -1);
+    auto hash = [&](size_t pos) { return (load32(data + pos) * 2654435761u) >> (32 - kLzHashBits); };
+    auto insert = [&](size_t pos) {
+        uint32_t h = hash(pos);
+        chain[pos & (kLzWindow - 1)] = head[h];
+        head[h] = static_cast<int32_t>(pos);
+    };
+
+    uint64_t matched = 0;
+    size_t pos = 0;
+    while (pos + kLzMinMatch <= n) {
+        size_t limit = std::min(n - pos, kLzMaxMatch), best = 0;
+        int32_t candidate = head[hash(pos)];
+        for (int depth = 0; depth < kLzMaxChain && candidate >= 0 && pos - candidate <= kLzWindow; depth++) {
+            size_t length = 0;
+            while (length < limit && data[candidate + length] == data[pos + length]) length++;
+            best = std::max(best, length);
+            // A slot reused by a newer position ends the chain
+            int32_t next = chain[candidate & (kLzWindow - 1)];
+            if (next >= candidate) break;
+            candidate = next;
+        }
+        if (best < kLzMinMatch) best = 1;
+        else matched += best;
+        for (size_t end = std::min(pos + best, n - kLzMinMatch + 1); pos < end; pos++) insert(pos);
+    }
+    return matched;
+}
+
+// ---- CRC32C ----------------------------------------------------------------
+
+const uint32_t kCrc32cPoly = 0x82F63B78u;     // Castagnoli, reflected
+
+// Slice-by-8 tables for the portable path, and the operator that advances
+// a CRC over kCrcBlock zero bytes for combining interleaved streams
+struct Crc32cTables {
+    uint32_t slice[8][256];
+    uint32_t shift[4][256];
+
+    Crc32cTables() {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t crc = n;
+            for (int k = 0; k < 8; k++) crc = crc & 1 ? (crc >> 1) ^ kCrc32cPoly : crc >> 1;
+            slice[0][n] = crc;
+        }
+        for (uint32_t n = 0; n < 256; n++) {
+            for (int k = 1; k < 8; k++) slice[k][n] = (slice[k - 1][n] >> 8) ^ slice[0][slice[k - 1][n] & 0xFF];
+        }
+
+        // GF(2) matrices: start with one zero bit, square up to kCrcBlock bytes
+        uint32_t odd[32], even[32];
+        odd[0] = kCrc32cPoly;
+        for (int n = 1; n < 32; n++) odd[n] = 1u << (n - 1);
+        square(even, odd);
+        square(odd, even);
+        for (size_t bytes = kCrcBlock; ; ) {
+            square(even, odd);     // even now covers one more doubling
+            bytes >>= 1;
+            if (bytes == 0) break;
+            square(odd, even);
+            bytes >>= 1;
+            if (bytes == 0) {
+                std::memcpy(even, odd, sizeof(even));
+                break;
+            }
+        }
+        for (uint32_t n = 0; n < 256; n++) {
+            for (int k = 0; k < 4; k++) shift[k][n] = times(even, n << (8 * k));
+        }
+    }
+
+    static uint32_t times(const uint32_t* matrix, uint32_t vector) {
+        uint32_t sum = 0;
+        for (; vector; vector >>= 1, matrix++) {
+            if (vector & 1) sum ^= *matrix;
+        }
+        return sum;
+    }
+
+    static void square(uint32_t* result, const uint32_t* matrix) {
+        for (int n = 0; n < 32; n++) result[n] = times(matrix, matrix[n]);
+    }
+
+    uint32_t shift_block(uint32_t crc) const {
+        return shift[0][crc & 0xFF] ^ shift[1][(crc >> 8) & 0xFF] ^ shift[2][(crc >> 16) & 0xFF] ^ shift[3][crc >> 24];
+    }
+};
+
+const Crc32cTables& crc32c_tables() {
+    static const Crc32cTables tables;
+    return tables;
+}
+
+uint32_t crc32c_portable(uint32_t crc, const uint8_t* data, size_t n) {
+    const auto& t = crc32c_tables().slice;
+    crc = ~crc;
+    for (; n >= 8; n -= 8, data += 8) {
+        uint32_t low = crc ^ load32(data), high = load32(data + 4);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+    for (; n > 0; n--, data++) crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xFF];
+    return ~crc;
+}
+
+#if defined(PCTESTER_X86_64)
+
+// The crc32 instruction has a 3-cycle latency but issues every cycle, so
+// three independent streams keep it busy; their CRCs are merged by
+// shifting over the following block
+SIMD_TARGET("sse4.2") uint32_t crc32c_sse42(uint32_t crc, const uint8_t* data, size_t n) {
+    const Crc32cTables& tables = crc32c_tables();
+    uint64_t crc0 = ~crc;
+    for (; n >= 3 * kCrcBlock; n -= 3 * kCrcBlock, data += 3 * kCrcBlock) {
+        uint64_t crc1 = 0, crc2 = 0;
+        for (size_t i = 0; i < kCrcBlock; i += 8) {
+            crc0 = _mm_crc32_u64(crc0, load64(data + i));
+            crc1 = _mm_crc32_u64(crc1, load64(data + kCrcBlock + i));
+            crc2 = _mm_crc32_u64(crc2, load64(data + 2 * kCrcBlock + i));
+        }
+        crc0 = tables.shift_block(static_cast<uint32_t>(crc0)) ^ crc1;
+        crc0 = tables.shift_block(static_cast<uint32_t>(crc0)) ^ crc2;
+    }
+    for (; n >= 8; n -= 8, data += 8) crc0 = _mm_crc32_u64(crc0, load64(data));
+    uint32_t tail = static_cast<uint32_t>(crc0);
+    for (; n > 0; n--, data++) tail = _mm_crc32_u8(tail, *data);
+    return ~tail;
+}
+
+#elif defined(PCTESTER_ARM64)
+
+// Same three-stream layout as the SSE4.2 path
+ARM_TARGET("+crc") uint32_t crc32c_armv8(uint32_t crc, const uint8_t* data, size_t n) {
+    const Crc32cTables& tables = crc32c_tables();
+    uint32_t crc0 = ~crc;
+    for (; n >= 3 * kCrcBlock; n -= 3 * kCrcBlock, data += 3 * kCrcBlock) {
+        uint32_t crc1 = 0, crc2 = 0;
+        for (size_t i = 0; i < kCrcBlock; i += 8) {
+            crc0 = __crc32cd(crc0, load64(data + i));
+            crc1 = __crc32cd(crc1, load64(data + kCrcBlock + i));
+            crc2 = __crc32cd(crc2, load64(data + 2 * kCrcBlock + i));
+        }
+        crc0 = tables.shift_block(crc0) ^ crc1;
+        crc0 = tables.shift_block(crc0) ^ crc2;
+    }
+    for (; n >= 8; n -= 8, data += 8) crc0 = __crc32cd(crc0, load64(data));
+    for (; n > 0; n--, data++) crc0 = __crc32cb(crc0, *data);
+    return ~crc0;
+}
+
+#endif
+
+uint32_t crc32c(uint32_t crc, const uint8_t* data, size_t n, bool hardware) {
+#if defined(PCTESTER_X86_64)
+    if (hardware) return crc32c_sse42(crc, data, n);
+#elif defined(PCTESTER_ARM64)
+    if (hardware) return crc32c_armv8(crc, data, n);
+#endif
+    (void)hardware;
+    return crc32c_portable(crc, data, n);
+}
+
+// ---- XXH64 -----------------------------------------------------------------
+
+const uint64_t kXxPrime1 = 11400714785074694791ull;
+const uint64_t kXxPrime2 = 14029467366897019727ull;
+const uint64_t kXxPrime3 = 1609587929392839161ull;
+const uint64_t kXxPrime4 = 9650029242287828579ull;
+const uint64_t kXxPrime5 = 2870177450012600261ull;
+
+uint64_t xx_round(uint64_t acc, uint64_t input) {
+    return rotl64(acc + input * kXxPrime2, 31) * kXxPrime1;
+}
+
+uint64_t xx_merge(uint64_t acc, uint64_t lane) {
+    return (acc ^ xx_round(0, lane)) * kXxPrime1 + kXxPrime4;
+}
+
+uint64_t xxh64(const uint8_t* data, size_t n, uint64_t seed) {
+    const uint8_t* end = data + n;
+    uint64_t h;
+    if (n >= 32) {
+        uint64_t v1 = seed + kXxPrime1 + kXxPrime2, v2 = seed + kXxPrime2, v3 = seed, v4 = seed - kXxPrime1;
+        for (; data + 32 <= end; data += 32) {
+            v1 = xx_round(v1, load64(data));
+            v2 = xx_round(v2, load64(data + 8));
+            v3 = xx_round(v3, load64(data + 16));
+            v4 = xx_round(v4, load64(data + 24));
+        }
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xx_merge(xx_merge(xx_merge(xx_merge(h, v1), v2), v3), v4);
+    } else {
+        h = seed + kXxPrime5;
+    }
+    h += n;
+    for (; data + 8 <= end; data += 8) h = rotl64(h ^ xx_round(0, load64(data)), 27) * kXxPrime1 + kXxPrime4;
+    if (data + 4 <= end) {
+        h = rotl64(h ^ (load32(data) * kXxPrime1), 23) * kXxPrime2 + kXxPrime3;
+        data += 4;
+    }
+    for (; data < end; data++) h = rotl64(h ^ (*data * kXxPrime5), 11) * kXxPrime1;
+    h ^= h >> 33;
+    h *= kXxPrime2;
+    h ^= h >> 29;
+    h *= kXxPrime3;
+    return h ^ (h >> 32);
+}
+
+// ---- AES-128-CTR -----------------------------------------------------------
+
+uint8_t xtime(uint8_t x) { return static_cast<uint8_t>((x << 1) ^ (x & 0x80 ? 0x1B : 0)); }
+
+struct AesTables {
+    uint8_t sbox[256];
+    // SubBytes and MixColumns of one byte in row r of a column, as a
+    // big-endian column word; the four rows are rotations of each other
+    uint32_t te[4][256];
+
+    // Walks GF(2^8) by multiplying p by 3 and q by its inverse, so q is
+    // always 1/p, then applies the affine transform
+    AesTables() {
+        uint8_t p = 1, q = 1;
+        do {
+            p = static_cast<uint8_t>(p ^ (p << 1) ^ (p & 0x80 ? 0x1B : 0));
+            q ^= q << 1;
+            q ^= q << 2;
+            q ^= q << 4;
+            if (q & 0x80) q ^= 0x09;
+            auto rotl8 = [](uint8_t x, int r) { return static_cast<uint8_t>((x << r) | (x >> (8 - r))); };
+            sbox[p] = q ^ rotl8(q, 1) ^ rotl8(q, 2) ^ rotl8(q, 3) ^ rotl8(q, 4) ^ 0x63;
+        } while (p != 1);
+        sbox[0] = 0x63;
+
+        for (int x = 0; x < 256; x++) {
+            uint32_t s = sbox[x], s2 = xtime(sbox[x]);
+            uint32_t word = s2 << 24 | s << 16 | s << 8 | (s2 ^ s);
+            for (int r = 0; r < 4; r++) te[r][x] = r == 0 ? word : word >> (8 * r) | word << (32 - 8 * r);
+        }
+    }
+};
+
+const AesTables& aes_tables() {
+    static const AesTables tables;
+    return tables;
+}
+
+const uint8_t* aes_sbox() {
+    return aes_tables().sbox;
+}
+
+uint32_t load_be32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) << 24 | p[1] << 16 | p[2] << 8 | p[3];
+}
+
+void store_be32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value >> 24);
+    p[1] = static_cast<uint8_t>(value >> 16);
+    p[2] = static_cast<uint8_t>(value >> 8);
+    p[3] = static_cast<uint8_t>(value);
+}
+
+// Eleven round keys, shared by both paths
+void aes128_expand(const uint8_t key[16], uint8_t round_keys[176]) {
+    const uint8_t* sbox = aes_sbox();
+    std::memcpy(round_keys, key, 16);
+    uint8_t rcon = 1;
+    for (int i = 16; i < 176; i += 4) {
+        uint8_t t[4] = { round_keys[i - 4], round_keys[i - 3], round_keys[i - 2], round_keys[i - 1] };
+        if (i % 16 == 0) {
+            uint8_t first = t[0];
+            t[0] = sbox[t[1]] ^ rcon;
+            t[1] = sbox[t[2]];
+            t[2] = sbox[t[3]];
+            t[3] = sbox[first];
+            rcon = xtime(rcon);
+        }
+        for (int j = 0; j < 4; j++) round_keys[i + j] = round_keys[i - 16 + j] ^ t[j];
+    }
+}
+
+// Table-driven rounds on the four column words: each round is sixteen
+// lookups, one per state byte, as in most software AES. The state is
+// column-major, so row r of column c is byte 4c + r.
+void aes128_encrypt_portable(const uint32_t round_keys[44], const uint8_t in[16], uint8_t out[16]) {
+    const AesTables& t = aes_tables();
+    uint32_t s[4], n[4];
+    for (int c = 0; c < 4; c++) s[c] = load_be32(in + 4 * c) ^ round_keys[c];
+    for (int round = 1; round < 10; round++) {
+        for (int c = 0; c < 4; c++) {
+            n[c] = t.te[0][s[c] >> 24] ^ t.te[1][(s[(c + 1) % 4] >> 16) & 0xFF] ^
+                   t.te[2][(s[(c + 2) % 4] >> 8) & 0xFF] ^ t.te[3][s[(c + 3) % 4] & 0xFF] ^ round_keys[4 * round + c];
+        }
+        std::memcpy(s, n, sizeof(s));
+    }
+    // The last round has no MixColumns
+    for (int c = 0; c < 4; c++) {
+        uint32_t word = static_cast<uint32_t>(t.sbox[s[c] >> 24]) << 24 | t.sbox[(s[(c + 1) % 4] >> 16) & 0xFF] << 16 |
+                        t.sbox[(s[(c + 2) % 4] >> 8) & 0xFF] << 8 | t.sbox[s[(c + 3) % 4] & 0xFF];
+        store_be32(out + 4 * c, word ^ round_keys[40 + c]);
+    }
+}
+
+// Counter blocks are the nonce then the block index, both little-endian
+void aes_ctr_portable(const uint8_t round_keys[176], uint64_t nonce, const uint8_t* in, uint8_t* out, size_t blocks) {
+    uint32_t key_words[44];
+    for (int i = 0; i < 44; i++) key_words[i] = load_be32(round_keys + 4 * i);
+    uint8_t counter[16], keystream[16];
+    std::memcpy(counter, &nonce, 8);
+    for (uint64_t block = 0; block < blocks; block++) {
+        std::memcpy(counter + 8, &block, 8);
+        aes128_encrypt_portable(key_words, counter, keystream);
+        for (int i = 0; i < 16; i++) out[16 * block + i] = in[16 * block + i] ^ keystream[i];
+    }
+}
+
+#if defined(PCTESTER_X86_64)
+
+// Eight blocks in flight hide the aesenc latency
+SIMD_TARGET("aes,sse2") void aes_ctr_aesni(const uint8_t round_keys[176], uint64_t nonce, const uint8_t* in,
+                                           uint8_t* out, size_t blocks) {
+    __m128i keys[11];
+    for (int r = 0; r < 11; r++) keys[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(round_keys + 16 * r));
+    uint64_t block = 0;
+    for (; block + 8 <= blocks; block += 8) {
+        __m128i b[8];
+        for (int j = 0; j < 8; j++) {
+            b[j] = _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(block + j), static_cast<long long>(nonce)), keys[0]);
+        }
+        for (int r = 1; r < 10; r++) {
+            for (int j = 0; j < 8; j++) b[j] = _mm_aesenc_si128(b[j], keys[r]);
+        }
+        for (int j = 0; j < 8; j++) {
+            const __m128i* src = reinterpret_cast<const __m128i*>(in + 16 * (block + j));
+            __m128i keystream = _mm_aesenclast_si128(b[j], keys[10]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (block + j)), _mm_xor_si128(_mm_loadu_si128(src), keystream));
+        }
+    }
+    for (; block < blocks; block++) {
+        __m128i b = _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(block), static_cast<long long>(nonce)), keys[0]);
+        for (int r = 1; r < 10; r++) b = _mm_aesenc_si128(b, keys[r]);
+        const __m128i* src = reinterpret_cast<const __m128i*>(in + 16 * block);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * block),
+                         _mm_xor_si128(_mm_loadu_si128(src), _mm_aesenclast_si128(b, keys[10])));
+    }
+}
+
+#elif defined(PCTESTER_ARM64)
+
+// aese adds the round key before SubBytes/ShiftRows, so the schedule runs
+// one key ahead of AES-NI and ends with a plain XOR
+ARM_TARGET("+crypto") inline uint8x16_t aes_block_armv8(const uint8x16_t keys[11], uint64_t nonce, uint64_t block) {
+    uint8x16_t b = vcombine_u8(vcreate_u8(nonce), vcreate_u8(block));
+    for (int r = 0; r < 9; r++) b = vaesmcq_u8(vaeseq_u8(b, keys[r]));
+    return veorq_u8(vaeseq_u8(b, keys[9]), keys[10]);
+}
+
+// Eight blocks in flight, as on x86
+ARM_TARGET("+crypto") void aes_ctr_armv8(const uint8_t round_keys[176], uint64_t nonce, const uint8_t* in,
+                                         uint8_t* out, size_t blocks) {
+    uint8x16_t keys[11];
+    for (int r = 0; r < 11; r++) keys[r] = vld1q_u8(round_keys + 16 * r);
+    uint64_t block = 0;
+    for (; block + 8 <= blocks; block += 8) {
+        uint8x16_t keystream[8];
+        for (int j = 0; j < 8; j++) keystream[j] = aes_block_armv8(keys, nonce, block + j);
+        for (int j = 0; j < 8; j++) {
+            vst1q_u8(out + 16 * (block + j), veorq_u8(vld1q_u8(in + 16 * (block + j)), keystream[j]));
+        }
+    }
+    for (; block < blocks; block++) {
+        vst1q_u8(out + 16 * block, veorq_u8(vld1q_u8(in + 16 * block), aes_block_armv8(keys, nonce, block)));
+    }
+}
+
+#endif
+
+void aes_ctr(const uint8_t round_keys[176], uint64_t nonce, const uint8_t* in, uint8_t* out, size_t blocks, bool hardware) {
+#if defined(PCTESTER_X86_64)
+    if (hardware) return aes_ctr_aesni(round_keys, nonce, in, out, blocks);
+#elif defined(PCTESTER_ARM64)
+    if (hardware) return aes_ctr_armv8(round_keys, nonce, in, out, blocks);
+#endif
+    (void)hardware;
+    aes_ctr_portable(round_keys, nonce, in, out, blocks);
+}
+
+// ---- SHA-256 ---------------------------------------------------------------
+
+const uint32_t kSha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+const uint32_t kSha256Initial[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+// Compression function only: the kernel hashes whole 64-byte blocks
+void sha256_blocks_portable(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    for (; blocks > 0; blocks--, data += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++) {
+            w[i] = static_cast<uint32_t>(data[4 * i]) << 24 | data[4 * i + 1] << 16 | data[4 * i + 2] << 8 | data[4 * i + 3];
+        }
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; i++) {
+            uint32_t t1 = h + (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) + ((e & f) ^ (~e & g)) + kSha256K[i] + w[i];
+            uint32_t t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#if defined(PCTESTER_X86_64)
+
+// sha256rnds2 works on the state split as ABEF/CDGH and runs two rounds;
+// message words are scheduled four at a time with sha256msg1/msg2
+SIMD_TARGET("sha,sse4.1,ssse3") void sha256_blocks_shani(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+    __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);
+    __m128i hgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+    __m128i abef = _mm_alignr_epi8(dcba, hgfe, 8);
+    __m128i cdgh = _mm_blend_epi16(hgfe, dcba, 0xF0);
+
+    for (; blocks > 0; blocks--, data += 64) {
+        __m128i abef_saved = abef, cdgh_saved = cdgh;
+        __m128i w[4];
+        for (int g = 0; g < 16; g++) {
+            if (g < 4) {
+                w[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * g)), byte_swap);
+            } else {
+                // W[g] = msg2(msg1(W[g-4], W[g-3]) + W[g-1:g-2 shifted one word], W[g-1])
+                __m128i previous = w[(g + 3) % 4];
+                __m128i next = _mm_sha256msg1_epu32(w[g % 4], w[(g + 1) % 4]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(previous, w[(g + 2) % 4], 4));
+                w[g % 4] = _mm_sha256msg2_epu32(next, previous);
+            }
+            __m128i message = _mm_add_epi32(w[g % 4], _mm_loadu_si128(reinterpret_cast<const __m128i*>(kSha256K + 4 * g)));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(message, 0x0E));
+        }
+        abef = _mm_add_epi32(abef, abef_saved);
+        cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+    }
+
+    __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+#elif defined(PCTESTER_ARM64)
+
+// sha256h/sha256h2 run four rounds on the ABCD and EFGH halves; the
+// message schedule advances four words at a time with sha256su0/su1
+ARM_TARGET("+crypto") void sha256_blocks_armv8(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    uint32x4_t abcd = vld1q_u32(state), efgh = vld1q_u32(state + 4);
+    for (; blocks > 0; blocks--, data += 64) {
+        uint32x4_t abcd_saved = abcd, efgh_saved = efgh;
+        uint32x4_t w[4];
+        for (int g = 0; g < 16; g++) {
+            if (g < 4) {
+                w[g] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * g)));
+            } else {
+                w[g % 4] = vsha256su1q_u32(vsha256su0q_u32(w[g % 4], w[(g + 1) % 4]), w[(g + 2) % 4], w[(g + 3) % 4]);
+            }
+            uint32x4_t message = vaddq_u32(w[g % 4], vld1q_u32(kSha256K + 4 * g));
+            uint32x4_t abcd_before = abcd;
+            abcd = vsha256hq_u32(abcd, efgh, message);
+            efgh = vsha256h2q_u32(efgh, abcd_before, message);
+        }
+        abcd = vaddq_u32(abcd, abcd_saved);
+        efgh = vaddq_u32(efgh, efgh_saved);
+    }
+    vst1q_u32(state, abcd);
+    vst1q_u32(state + 4, efgh);
+}
+
+#endif
+
+void sha256_blocks(uint32_t state[8], const uint8_t* data, size_t blocks, bool hardware) {
+#if defined(PCTESTER_X86_64)
+    if (hardware) return sha256_blocks_shani(state, data, blocks);
+#elif defined(PCTESTER_ARM64)
+    if (hardware) return sha256_blocks_armv8(state, data, blocks);
+#endif
+    (void)hardware;
+    sha256_blocks_portable(state, data, blocks);
+}
+
+// ---- Bytecode interpreter --------------------------------------------------
+
+enum class Op : uint8_t { Add, Xor, Mul, Shift, Load, Store, Branch, Jump };
+
+struct Instruction {
+    Op op;
+    uint8_t a, b, c;
+    uint32_t target;
+};
+
+// A quarter of the instructions are short forward branches on a bit of a
+// register whose value is effectively random, so about half of them are
+// mispredicted; every operation keeps the registers' entropy
+std::vector<Instruction> make_program() {
+    std::mt19937 rng(7);
+    std::vector<Instruction> program(kProgramLength);
+    for (size_t pc = 0; pc + 1 < program.size(); pc++) {
+        Instruction& instruction = program[pc];
+        uint32_t pick = rng() % 16;
+        instruction.op = pick < 4 ? Op::Add : pick < 7 ? Op::Xor : pick < 9 ? Op::Mul : pick < 10 ? Op::Shift :
+                         pick < 11 ? Op::Load : pick < 12 ? Op::Store : Op::Branch;
+        instruction.a = static_cast<uint8_t>(rng() % 8);
+        instruction.b = static_cast<uint8_t>((instruction.a + 1 + rng() % 7) % 8);
+        instruction.c = static_cast<uint8_t>(1 + rng() % 31);
+        instruction.target = static_cast<uint32_t>(std::min<size_t>(pc + 2 + rng() % 15, program.size() - 1));
+    }
+    program.back() = { Op::Jump, 0, 0, 0, 0 };
+    return program;
+}
+
+uint32_t interpret(const std::vector<Instruction>& program, uint64_t steps, uint32_t regs[8], uint32_t memory[256]) {
+    const Instruction* code = program.data();
+    size_t pc = 0;
+    for (uint64_t step = 0; step < steps; step++) {
+        const Instruction& in = code[pc++];
+        switch (in.op) {
+            case Op::Add:    regs[in.a] += regs[in.b] + in.c; break;
+            case Op::Xor:    regs[in.a] ^= regs[in.b] << (in.c & 15); break;
+            case Op::Mul:    regs[in.a] = (regs[in.a] ^ regs[in.b]) * 0x9E3779B1u + in.c; break;
+            case Op::Shift:  regs[in.a] ^= regs[in.a] >> (in.c & 15 ? in.c & 15 : 1); break;
+            case Op::Load:   regs[in.a] += memory[regs[in.b] & 255]; break;
+            case Op::Store:  memory[regs[in.b] & 255] = regs[in.a]; break;
+            case Op::Branch: if ((regs[in.a] >> in.c) & 1) pc = in.target; break;
+            case Op::Jump:   pc = in.target; break;
+        }
+    }
+    uint32_t sum = 0;
+    for (int i = 0; i < 8; i++) sum += regs[i];
+    return sum;
+}
+
+// Calls chunk() until the time budget is spent and returns work units per second
+template<typename F>
+double measure_rate(F&& chunk, double work_per_chunk, double seconds) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(seconds);
+    uint64_t chunks = 0;
+    auto now = start;
+    do {
+        chunk();
+        chunks++;
+        now = std::chrono::steady_clock::now();
+    } while (now < deadline);
+    std::chrono::duration<double> elapsed = now - start;
+    return chunks * work_per_chunk / elapsed.count();
+}
+
+} // namespace
+
+const std::vector<CpuWorkloadInfo>& cpu_workloads() {
+    static const std::vector<CpuWorkloadInfo> workloads(std::begin(kWorkloads), std::end(kWorkloads));
+    return workloads;
+}
+
+const CpuWorkloadInfo& fp_series_workload() {
+    return kFpSeries;
+}
+
+// Extensions the kernels have code for on this architecture
+static CpuExtensions usable_extensions() {
+#if defined(PCTESTER_X86_64) || defined(PCTESTER_ARM64)
+    return detect_cpu_extensions();
+#else
+    return CpuExtensions{};
+#endif
+}
+
+std::string cpu_workload_engine(CpuWorkload workload) {
+    CpuExtensions extensions = usable_extensions();
+#if defined(PCTESTER_ARM64)
+    const char* names[] = { "ARMv8 CRC32", "ARMv8 AES", "ARMv8 SHA2" };
+#else
+    const char* names[] = { "SSE4.2", "AES-NI", "SHA-NI" };
+#endif
+    switch (workload) {
+        case CpuWorkload::Crc32c: return extensions.crc32c ? names[0] : kPortableEngine;
+        case CpuWorkload::Aes:    return extensions.aes ? names[1] : kPortableEngine;
+        case CpuWorkload::Sha256: return extensions.sha256 ? names[2] : kPortableEngine;
+        default:                  return kPortableEngine;
+    }
+}
+
+double run_cpu_workload(CpuWorkload workload, double seconds) {
+    CpuExtensions extensions = usable_extensions();
+    std::vector<uint8_t> buffer = make_corpus(kBufferBytes);
+    volatile uint64_t sink = 0;
+
+    switch (workload) {
+        case CpuWorkload::Lz: {
+            std::vector<int32_t> head(size_t(1) << kLzHashBits), chain(kLzWindow);
+            return measure_rate([&]() { sink = sink + lz_match(buffer.data(), buffer.size(), head, chain); },
+                                static_cast<double>(buffer.size()), seconds) / 1e6;
+        }
+        case CpuWorkload::Crc32c:
+            return measure_rate([&]() { sink = sink + crc32c(0, buffer.data(), buffer.size(), extensions.crc32c); },
+                                static_cast<double>(buffer.size()), seconds) / 1e9;
+        case CpuWorkload::XxHash:
+            return measure_rate([&]() { sink = sink + xxh64(buffer.data(), buffer.size(), sink); },
+                                static_cast<double>(buffer.size()), seconds) / 1e9;
+        case CpuWorkload::Aes: {
+            const uint8_t key[16] = { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                      0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+            uint8_t round_keys[176];
+            aes128_expand(key, round_keys);
+            std::vector<uint8_t> out(buffer.size());
+            size_t blocks = buffer.size() / 16;
+            return measure_rate([&]() {
+                aes_ctr(round_keys, sink, buffer.data(), out.data(), blocks, extensions.aes);
+                sink = sink + out[0];
+            }, static_cast<double>(blocks * 16), seconds) / 1e9;
+        }
+        case CpuWorkload::Sha256: {
+            uint32_t state[8];
+            std::memcpy(state, kSha256Initial, sizeof(state));
+            size_t blocks = buffer.size() / 64;
+            return measure_rate([&]() {
+                sha256_blocks(state, buffer.data(), blocks, extensions.sha256);
+                sink = sink + state[0];
+            }, static_cast<double>(blocks * 64), seconds) / 1e6;
+        }
+        case CpuWorkload::Sort: {
+            std::mt19937 rng(99);
+            std::vector<uint32_t> keys(kSortKeys), work;
+            for (auto& key : keys) key = rng();
+            return measure_rate([&]() {
+                work = keys;
+                std::sort(work.begin(), work.end());
+                sink = sink + work[kSortKeys / 2];
+            }, static_cast<double>(kSortKeys), seconds) / 1e6;
+        }
+        case CpuWorkload::Interpreter: {
+            std::vector<Instruction> program = make_program();
+            uint32_t regs[8], memory[256];
+            for (int i = 0; i < 8; i++) regs[i] = 0x12345678u * (i + 1);
+            for (int i = 0; i < 256; i++) memory[i] = static_cast<uint32_t>(i) * 2654435761u;
+            return measure_rate([&]() { sink = sink + interpret(program, kInterpreterSteps, regs, memory); },
+                                static_cast<double>(kInterpreterSteps), seconds) / 1e6;
+        }
+    }
+    return 0.0;
+}
+
+CpuWorkloadScore score_cpu_workload(const CpuWorkloadInfo& info, const std::string& engine, double rate) {
+    CpuWorkloadScore score;
+    score.name = info.name;
+    score.unit = info.unit;
+    score.engine = engine;
+    score.rate = rate;
+    score.score = info.reference > 0.0 ? 1000.0 * rate / info.reference : 0.0;
+    // A portable fallback is not what the reference measured; counting it
+    // would mostly score the missing instruction
+    score.weight = info.hardware_reference && engine == kPortableEngine ? 0.0 : info.weight;
+    return score;
+}
+
+double cpu_composite_score(const std::vector<CpuWorkloadScore>& scores) {
+    double log_sum = 0.0, weight_sum = 0.0;
+    for (const auto& score : scores) {
+        if (score.score <= 0.0 || score.weight <= 0.0) continue;
+        log_sum += score.weight * std::log(score.score);
+        weight_sum += score.weight;
+    }
+    return weight_sum > 0.0 ? std::exp(log_sum / weight_sum) : 0.0;
+}
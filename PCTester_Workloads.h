@@ -0,0 +1,51 @@
+#pragma once
+
+#include "PCTester.h"
+#include <string>
+#include <vector>
+
+// Integer, branch-heavy and cryptographic kernels that look more like
+// service code than a floating-point reduction does. Each runs on the
+// calling thread over a cache-resident buffer. Hardware paths (SSE4.2,
+// AES-NI and SHA-NI on x86, the CRC32 and crypto extensions on ARMv8) are
+// picked at run time with portable fallbacks, so every host runs every
+// kernel. A fallback is reported but left out of the composite, which
+// keeps composites comparable across hosts with and without the
+// instructions.
+enum class CpuWorkload {
+    Lz,             // LZ77 hash-chain match finding, MB/s of input
+    Crc32c,         // GB/s
+    XxHash,         // XXH64, GB/s
+    Aes,            // AES-128-CTR, GB/s
+    Sha256,         // MB/s
+    Sort,           // std::sort of 32-bit keys, Mkeys/s
+    Interpreter     // bytecode VM with data-dependent branches, Minstr/s
+};
+
+struct CpuWorkloadInfo {
+    const char* name;
+    const char* unit;
+    double reference;   // rate that scores 1000
+    double weight;      // share of the composite; all weights sum to 1
+    bool hardware_reference;    // reference taken on a hardware path
+};
+
+// Every kernel, indexed by CpuWorkload
+const std::vector<CpuWorkloadInfo>& cpu_workloads();
+
+// The platform's floating-point series score (Mterms/s, single thread)
+// joins the composite under this entry
+const CpuWorkloadInfo& fp_series_workload();
+
+// Hardware path run_cpu_workload takes on this host, or "portable"
+std::string cpu_workload_engine(CpuWorkload workload);
+
+// Runs one kernel for roughly seconds and returns its rate in the unit above
+double run_cpu_workload(CpuWorkload workload, double seconds);
+
+// Weight is 0 when a kernel with a hardware reference ran its portable path
+CpuWorkloadScore score_cpu_workload(const CpuWorkloadInfo& info, const std::string& engine, double rate);
+
+// Weighted geometric mean of the scores, so no single kernel dominates;
+// the weights of the kernels left in are renormalized
+double cpu_composite_score(const std::vector<CpuWorkloadScore>& scores);
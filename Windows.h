@@ -1,18 +1,14 @@
+#include "PCTester_Scheduler.h"
 #include <vector>
-#include <queue>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
-#include <functional>
 #include <atomic>
-#include <future>
 #include <random>
 #include <fstream>
 #include <cmath>
 #include <iomanip>
 #include <chrono>
 #include <algorithm>
-#include <tuple>
 #include <windows.h>
 
 class PCTester::Impl {
@@ -21,25 +17,7 @@ public:
     void run_full_diagnostics();
 
 private:
-    // Task scheduler with Windows optimizations
-    class TaskScheduler {
-    public:
-        TaskScheduler(size_t num_workers = 1);
-        ~TaskScheduler();
-
-        template<typename F, typename... Args>
-        auto submit(F&& f, Args&&... args) 
-            -> std::future<std::invoke_result_t<F, Args...>>;
-            
-    private:
-        void process_tasks();
-        std::vector<std::thread> workers;
-        std::queue<std::function<void()>> tasks;
-        std::mutex queue_mutex;
-        std::condition_variable condition;
-        std::atomic<bool> stop;
-    };
-
+    // Shared work-stealing pool, one pinned worker per logical CPU
     TaskScheduler scheduler;
     
     // Diagnostic tests with Windows-specific optimizations
@@ -52,28 +30,6 @@ private:
     std::string get_random_progress_message();
 };
 
-// Windows-specific task scheduler implementation
-template<typename F, typename... Args>
-auto PCTester::Impl::TaskScheduler::submit(F&& f, Args&&... args) 
-    -> std::future<std::invoke_result_t<F, Args...>> {
-    
-    using return_type = std::invoke_result_t<F, Args...>;
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        [f = std::forward<F>(f), 
-         args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
-            return std::apply(f, args);
-        }
-    );
-    
-    std::future<return_type> result = task->get_future();
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.emplace([task]() { (*task)(); });
-    }
-    condition.notify_one();
-    return result;
-}
-
 // Windows-specific test implementations
 double PCTester::Impl::cpu_benchmark() {
     SafeOutput::print("[CPU] Starting Windows-optimized stress test...");
@@ -96,7 +52,7 @@ double PCTester::Impl::network_latency_test() {
 }
 
 // Windows-specific initialization
-PCTester::Impl::Impl() : scheduler(4) {
+PCTester::Impl::Impl() {
     // Windows-specific initialization
     SetPriorityClass(GetCurrentProcess(), HIGH_PRIORITY_CLASS);
 }
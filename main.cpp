@@ -1,20 +1,67 @@
 #include "PCTester.h"
+#include "PCTester_Options.h"
 #include <iostream>
 
-int main() {
-    PCTester tester;
+int main(int argc, char* argv[]) {
+    RunOptions options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n\n" << options_usage();
+        return 2;
+    }
+    if (options.help) {
+        std::cout << options_usage();
+        return 0;
+    }
+    if (options.list_stages) {
+        for (const std::string& stage : PCTester::stage_names()) std::cout << stage << "\n";
+        return 0;
+    }
+    if (options.network_server) {
+        PCTester::run_network_server(options.config.network_port);
+        return 0;
+    }
+    SafeOutput::set_quiet(options.quiet);
+    
+    PCTester tester(options.config);
+    if (options.daemon) {
+        try {
+            tester.run_daemon();
+        } catch (const std::exception& e) {
+            SafeOutput::error(e.what());
+            SafeOutput::flush();
+            return 1;
+        }
+        SafeOutput::flush();
+        return 0;
+    }
     SafeOutput::print("=== Advanced PCTester v3.0 ===");
     SafeOutput::print("Starting comprehensive hardware diagnostics...");
     
+    int exit_code = 0;
     try {
-        tester.run_full_diagnostics();
-        tester.generate_html_report("diagnostic_report.html");
+        if (options.stages.empty()) {
+            tester.run_full_diagnostics();
+        } else {
+            tester.run_stages(options.stages);
+        }
+        // Regressions fail the run so scripts can gate on the exit status
+        if (!options.baseline_path.empty() && tester.compare_to_baseline(options.baseline_path) > 0) exit_code = 1;
+        if (!options.html_path.empty()) tester.generate_html_report(options.html_path);
+        if (!options.json_path.empty()) tester.export_results(options.json_path, ResultFormat::JsonLines);
+        if (!options.csv_path.empty()) tester.export_results(options.csv_path, ResultFormat::Csv);
         SafeOutput::print("\nDiagnostics completed successfully!");
     } catch (const std::exception& e) {
-        SafeOutput::print("\nERROR: " + std::string(e.what()));
+        SafeOutput::error(e.what());
+        exit_code = 1;
     }
     
-    SafeOutput::print("Press Enter to exit...");
-    std::cin.get();
-    return 0;
+    if (options.wait) {
+        SafeOutput::print("Press Enter to exit...");
+        SafeOutput::flush();
+        std::cin.get();
+    }
+    SafeOutput::flush();
+    return exit_code;
 }